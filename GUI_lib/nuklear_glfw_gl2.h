@@ -20,8 +20,13 @@ enum nk_glfw_init_state{
     NK_GLFW3_INSTALL_CALLBACKS
 };
 NK_API struct nk_context*   nk_glfw3_init(GLFWwindow *win, enum nk_glfw_init_state);
+NK_API struct nk_context*   nk_glfw3_init_fixed(GLFWwindow *win, enum nk_glfw_init_state, void *memory, nk_size size);
+NK_API nk_size              nk_glfw3_heap_allocations(void);
 NK_API void                 nk_glfw3_font_stash_begin(struct nk_font_atlas **atlas);
 NK_API void                 nk_glfw3_font_stash_end(void);
+NK_API void                 nk_glfw3_font_stash_upload(const void *image, int width, int height);
+NK_API void                 nk_glfw3_font_stash_load(const void *image, int width, int height, struct nk_vec2 null_uv,
+                                struct nk_font_glyph *glyphs, struct nk_font *fonts, const float *pixel_heights, int font_count);
 
 NK_API void                 nk_glfw3_new_frame(void);
 NK_API void                 nk_glfw3_render(enum nk_anti_aliasing);
@@ -54,9 +59,21 @@ NK_API void                 nk_glfw3_mouse_button_callback(GLFWwindow* window, i
 #ifndef NK_GLFW_DOUBLE_CLICK_HI
 #define NK_GLFW_DOUBLE_CLICK_HI 0.2
 #endif
+/* starting sizes of the draw buffers; they grow to the largest frame seen and stay there */
+#ifndef NK_GLFW_COMMAND_BUFFER_SIZE
+#define NK_GLFW_COMMAND_BUFFER_SIZE (16 * 1024)
+#endif
+#ifndef NK_GLFW_VERTEX_BUFFER_SIZE
+#define NK_GLFW_VERTEX_BUFFER_SIZE (512 * 1024)
+#endif
+#ifndef NK_GLFW_ELEMENT_BUFFER_SIZE
+#define NK_GLFW_ELEMENT_BUFFER_SIZE (128 * 1024)
+#endif
 
 struct nk_glfw_device {
     struct nk_buffer cmds;
+    struct nk_buffer vertices;
+    struct nk_buffer elements;
     struct nk_draw_null_texture tex_null;
     GLuint font_tex;
 };
@@ -83,8 +100,32 @@ static struct nk_glfw {
     int is_double_click_down;
     struct nk_vec2 double_click_pos;
     float delta_time_seconds_last;
+    struct nk_allocator alloc;
+    nk_size heap_allocations;
 } glfw;
 
+/* every heap allocation the backend and its context make goes through here and is counted */
+NK_INTERN void*
+nk_glfw3_heap_alloc(nk_handle unused, void *old, nk_size size)
+{
+    (void)unused; (void)old;
+    glfw.heap_allocations++;
+    return malloc(size);
+}
+
+NK_INTERN void
+nk_glfw3_heap_free(nk_handle unused, void *ptr)
+{
+    (void)unused;
+    free(ptr);
+}
+
+NK_API nk_size
+nk_glfw3_heap_allocations(void)
+{
+    return glfw.heap_allocations;
+}
+
 NK_INTERN void
 nk_glfw3_device_upload_atlas(const void *image, int width, int height)
 {
@@ -132,7 +173,6 @@ nk_glfw3_render(enum nk_anti_aliasing AA)
         /* convert from command queue into draw list and draw to screen */
         const struct nk_draw_command *cmd;
         const nk_draw_index *offset = NULL;
-        struct nk_buffer vbuf, ebuf;
 
         /* fill convert configuration */
         struct nk_convert_config config;
@@ -155,18 +195,18 @@ nk_glfw3_render(enum nk_anti_aliasing AA)
         config.line_AA = AA;
 
         /* convert shapes into vertexes */
-        nk_buffer_init_default(&vbuf);
-        nk_buffer_init_default(&ebuf);
-        nk_convert(&glfw.ctx, &dev->cmds, &vbuf, &ebuf, &config);
+        nk_buffer_clear(&dev->vertices);
+        nk_buffer_clear(&dev->elements);
+        nk_convert(&glfw.ctx, &dev->cmds, &dev->vertices, &dev->elements, &config);
 
         /* setup vertex buffer pointer */
-        {const void *vertices = nk_buffer_memory_const(&vbuf);
+        {const void *vertices = nk_buffer_memory_const(&dev->vertices);
         glVertexPointer(2, GL_FLOAT, vs, (const void*)((const nk_byte*)vertices + vp));
         glTexCoordPointer(2, GL_FLOAT, vs, (const void*)((const nk_byte*)vertices + vt));
         glColorPointer(4, GL_UNSIGNED_BYTE, vs, (const void*)((const nk_byte*)vertices + vc));}
 
         /* iterate over and execute each draw command */
-        offset = (const nk_draw_index*)nk_buffer_memory_const(&ebuf);
+        offset = (const nk_draw_index*)nk_buffer_memory_const(&dev->elements);
         nk_draw_foreach(cmd, &glfw.ctx, &dev->cmds)
         {
             if (!cmd->elem_count) continue;
@@ -181,8 +221,6 @@ nk_glfw3_render(enum nk_anti_aliasing AA)
         }
         nk_clear(&glfw.ctx);
         nk_buffer_clear(&dev->cmds);
-        nk_buffer_free(&vbuf);
-        nk_buffer_free(&ebuf);
     }
 
     /* default OpenGL state */
@@ -309,8 +347,9 @@ nk_glfw3_clipboard_copy(nk_handle usr, const char *text, int len)
     free(str);
 }
 
-NK_API struct nk_context*
-nk_glfw3_init(GLFWwindow *win, enum nk_glfw_init_state init_state)
+/* context memory: a fixed block when one is given, otherwise the counted heap */
+NK_INTERN struct nk_context*
+nk_glfw3_init_context(GLFWwindow *win, enum nk_glfw_init_state init_state, void *memory, nk_size size)
 {
     glfw.win = win;
     if (init_state == NK_GLFW3_INSTALL_CALLBACKS) {
@@ -319,11 +358,18 @@ nk_glfw3_init(GLFWwindow *win, enum nk_glfw_init_state init_state)
         glfwSetKeyCallback(win, nk_glfw3_key_callback);
         glfwSetMouseButtonCallback(win, nk_glfw3_mouse_button_callback);
     }
-    nk_init_default(&glfw.ctx, 0);
+    glfw.alloc.userdata = nk_handle_ptr(0);
+    glfw.alloc.alloc = nk_glfw3_heap_alloc;
+    glfw.alloc.free = nk_glfw3_heap_free;
+    if (memory)
+        nk_init_fixed(&glfw.ctx, memory, size, 0);
+    else nk_init(&glfw.ctx, &glfw.alloc, 0);
     glfw.ctx.clip.copy = nk_glfw3_clipboard_copy;
     glfw.ctx.clip.paste = nk_glfw3_clipboard_paste;
     glfw.ctx.clip.userdata = nk_handle_ptr(0);
-    nk_buffer_init_default(&glfw.ogl.cmds);
+    nk_buffer_init(&glfw.ogl.cmds, &glfw.alloc, NK_GLFW_COMMAND_BUFFER_SIZE);
+    nk_buffer_init(&glfw.ogl.vertices, &glfw.alloc, NK_GLFW_VERTEX_BUFFER_SIZE);
+    nk_buffer_init(&glfw.ogl.elements, &glfw.alloc, NK_GLFW_ELEMENT_BUFFER_SIZE);
 
     glfw.is_double_click_down = nk_false;
     glfw.double_click_pos = nk_vec2(0, 0);
@@ -333,25 +379,66 @@ nk_glfw3_init(GLFWwindow *win, enum nk_glfw_init_state init_state)
     return &glfw.ctx;
 }
 
+NK_API struct nk_context*
+nk_glfw3_init(GLFWwindow *win, enum nk_glfw_init_state init_state)
+{
+    return nk_glfw3_init_context(win, init_state, 0, 0);
+}
+
+NK_API struct nk_context*
+nk_glfw3_init_fixed(GLFWwindow *win, enum nk_glfw_init_state init_state, void *memory, nk_size size)
+{
+    return nk_glfw3_init_context(win, init_state, memory, size);
+}
+
 NK_API void
 nk_glfw3_font_stash_begin(struct nk_font_atlas **atlas)
 {
-    nk_font_atlas_init_default(&glfw.atlas);
+    nk_font_atlas_init(&glfw.atlas, &glfw.alloc);
     nk_font_atlas_begin(&glfw.atlas);
     *atlas = &glfw.atlas;
 }
 
+/* second half of nk_glfw3_font_stash_end, for callers that bake the atlas themselves */
 NK_API void
-nk_glfw3_font_stash_end(void)
+nk_glfw3_font_stash_upload(const void *image, int width, int height)
 {
-    const void *image; int w, h;
-    image = nk_font_atlas_bake(&glfw.atlas, &w, &h, NK_FONT_ATLAS_RGBA32);
-    nk_glfw3_device_upload_atlas(image, w, h);
+    nk_glfw3_device_upload_atlas(image, width, height);
     nk_font_atlas_end(&glfw.atlas, nk_handle_id((int)glfw.ogl.font_tex), &glfw.ogl.tex_null);
     if (glfw.atlas.default_font)
         nk_style_set_font(&glfw.ctx, &glfw.atlas.default_font->handle);
 }
 
+NK_API void
+nk_glfw3_font_stash_end(void)
+{
+    const void *image; int w, h;
+    image = nk_font_atlas_bake(&glfw.atlas, &w, &h, NK_FONT_ATLAS_RGBA32);
+    nk_glfw3_font_stash_upload(image, w, h);
+}
+
+/* uses an atlas baked earlier instead of baking one: `fonts` come with their info,
+ * fallback_codepoint and config filled in and are set up to draw from `image` */
+NK_API void
+nk_glfw3_font_stash_load(const void *image, int width, int height, struct nk_vec2 null_uv,
+    struct nk_font_glyph *glyphs, struct nk_font *fonts, const float *pixel_heights, int font_count)
+{
+    int i;
+    nk_handle texture;
+    nk_font_atlas_init(&glfw.atlas, &glfw.alloc);
+    nk_glfw3_device_upload_atlas(image, width, height);
+    texture = nk_handle_id((int)glfw.ogl.font_tex);
+    glfw.ogl.tex_null.texture = texture;
+    glfw.ogl.tex_null.uv = null_uv;
+    for (i = 0; i < font_count; ++i) {
+        struct nk_baked_font baked = fonts[i].info;
+        nk_font_init(&fonts[i], pixel_heights[i], fonts[i].fallback_codepoint, glyphs, &baked, texture);
+        fonts[i].next = (i + 1 < font_count) ? &fonts[i + 1] : 0;
+    }
+    if (font_count > 0)
+        nk_style_set_font(&glfw.ctx, &fonts[0].handle);
+}
+
 NK_API void
 nk_glfw3_new_frame(void)
 {
@@ -449,6 +536,8 @@ void nk_glfw3_shutdown(void)
     nk_free(&glfw.ctx);
     glDeleteTextures(1, &dev->font_tex);
     nk_buffer_free(&dev->cmds);
+    nk_buffer_free(&dev->vertices);
+    nk_buffer_free(&dev->elements);
     memset(&glfw, 0, sizeof(glfw));
 }
 
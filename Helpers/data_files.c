@@ -0,0 +1,29 @@
+// file: data_files.c
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "../data_files.h"
+
+/**
+ * @brief Finds a data file relative to the executable, falling back to the working directory.
+ * @return true and the path in `out` if the file exists.
+ */
+bool find_data_file(const char *argv0, const char *relative_path, char *out, size_t out_size)
+{
+    char directory[4096] = "";
+#ifdef __linux__
+    ssize_t length = readlink("/proc/self/exe", directory, sizeof(directory) - 1);
+    directory[length > 0 ? length : 0] = '\0';
+#endif
+    if (directory[0] == '\0' && argv0 != NULL && strchr(argv0, '/') != NULL) {
+        snprintf(directory, sizeof(directory), "%s", argv0);
+    }
+    char *slash = strrchr(directory, '/');
+    if (slash != NULL) {
+        *slash = '\0';
+        if (snprintf(out, out_size, "%s/%s", directory, relative_path) < (int)out_size && access(out, R_OK) == 0) return true;
+    }
+    if (snprintf(out, out_size, "%s", relative_path) < (int)out_size && access(out, R_OK) == 0) return true;
+    return false;
+}
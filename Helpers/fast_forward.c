@@ -0,0 +1,99 @@
+// file: fast_forward.c
+
+#include <stdbool.h>
+#include "../fast_forward.h"
+#include "../game_config.h"
+#include "../logger.h"
+#include "../cohorts.h"
+#include "../calculations.h"
+#include "../shared_data.h"
+#include "../player.h"
+#include "../journal.h"
+
+/**
+ * @brief Whether a new story position or player orders are waiting for the next hour.
+ * They are taken at the start of a simulated hour, so the night must not skip past it.
+ * The GUI decides when, so a replay goes by the recording instead.
+ */
+static bool player_is_waiting(int day, int hour)
+{
+    pthread_mutex_lock(&g_story_mutex);
+    bool waiting = g_story_position_changed;
+    pthread_mutex_unlock(&g_story_mutex);
+    if (player_commands_waiting() > 0) waiting = true;
+    return journal_player_waiting(JOURNAL_TICK(day, hour), waiting);
+}
+
+/**
+ * @brief Whether `hour` can be advanced without simulating anyone one by one.
+ * Work fills WORK_START_HOUR to WORK_END_HOUR and the council the last hour, so only the
+ * hours before work and the one after it can ever be quiet.
+ */
+static bool is_quiet_hour(const struct Kingdom kingdoms[], const int rebels[NUM_KINGDOMS], int hour, bool player_waiting)
+{
+    if (hour >= WORK_START_HOUR && hour < WORK_END_HOUR) return false; // Work
+    if (hour >= DAY_IN_HOURS - 1) return false;                         // The daily council and events
+    if (player_waiting) return false;                                   // The story moved or orders were given
+
+    for (int k = 0; k < NUM_KINGDOMS; k++) {
+        const struct Kingdom *kingdom = &kingdoms[k];
+        if (!kingdom->is_active) continue;
+        if (rebels[k] > 0) return false;                                // Skirmishes
+        if (kingdom->food <= 1 || kingdom->famine_hours > 0) return false; // Famine
+        if (kingdom->story_skirmish_override != 0) return false;       // A scripted battle is waiting
+    }
+    return true;
+}
+
+int fast_forward_quiet_hours(struct Kingdom kingdoms[], const int rebels[NUM_KINGDOMS], struct HumanPopulation *world_stat,
+                             struct Human_Data *data, int day, int hour)
+{
+    if (!is_quiet_hour(kingdoms, rebels, hour, false)) return 0;
+    bool player_waiting = player_is_waiting(day, hour);
+
+    int hours = 0;
+    while (hours < FAST_FORWARD_MAX_HOURS && is_quiet_hour(kingdoms, rebels, hour + hours, player_waiting)) hours++;
+    if (hours == 0) return 0;
+
+    // Every kingdom's steady rates, hour by hour, as the normal tick would accumulate them.
+    // Citizens with an age die by the calendar; the death sums only matter for the cohorts.
+    int population = 0;
+    for (int k = 0; k < NUM_KINGDOMS; k++) {
+        if (kingdoms[k].is_active) population += kingdoms[k].population;
+    }
+    if (population == 0) population = world_stat->human_population;
+
+    int total_births[NUM_KINGDOMS] = {0}, total_deaths[NUM_KINGDOMS] = {0};
+    for (int h = 0; h < hours; h++) {
+        int births[NUM_KINGDOMS], deaths[NUM_KINGDOMS];
+        calculate_population_changes(kingdoms, births, deaths);
+        for (int k = 0; k < NUM_KINGDOMS; k++) {
+            total_births[k] += births[k];
+            total_deaths[k] += deaths[k];
+            kingdoms[k].population += births[k] - deaths[k]; // Replaced by the census below
+        }
+    }
+
+    natural_deaths(data, total_deaths, total_births, population, day, hour, hours);
+    if (g_cohorts.enabled) {
+        cohort_births(kingdoms, total_births);
+    } else {
+        persona(total_births, world_stat, data);
+    }
+
+    // One census for the whole stretch
+    recalculate_kingdom_populations(kingdoms, data);
+    int total_population = 0;
+    for (int k = 0; k < NUM_KINGDOMS; k++) {
+        if (kingdoms[k].is_active) total_population += kingdoms[k].population;
+    }
+    world_stat->human_population = total_population;
+
+    for (int h = hour; h < hour + hours; h++) {
+        if (h % LOG_CLEAR_FREQUENCY_HOURS == 0) {
+            clear_old_log_entries();
+            break;
+        }
+    }
+    return hours;
+}
@@ -0,0 +1,189 @@
+// file: history.c
+
+#include <pthread.h>
+#include "../history.h"
+#include "../game_config.h"
+#include "../calculations.h"
+
+#define HISTORY_LEVELS 3
+#define HISTORY_TOTAL_SAMPLES (HISTORY_HOURLY_SAMPLES + HISTORY_DAILY_SAMPLES + HISTORY_MONTHLY_SAMPLES)
+
+// A sample of the next level that is still being filled
+struct HistoryAccumulator {
+    float min;
+    float max;
+    double sum; // Of the values times the hours they lasted
+    int hours;
+};
+
+// One ring of samples. The rings of all kingdoms and metrics fill in step, so they share it.
+struct HistoryLevel {
+    int capacity;
+    int hours_per_sample;
+    int offset; // Where the ring starts in `samples`
+    int next;   // Slot written next
+    int count;
+};
+
+static struct {
+    pthread_mutex_t mutex;
+    struct HistoryLevel levels[HISTORY_LEVELS];
+    struct HistorySample samples[NUM_KINGDOMS][HISTORY_METRICS][HISTORY_TOTAL_SAMPLES];
+    struct HistoryAccumulator pending[HISTORY_LEVELS][NUM_KINGDOMS][HISTORY_METRICS]; // Level 0 has none: every hour is a sample
+    long long recorded_hours;
+} history = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .levels = {
+        {HISTORY_HOURLY_SAMPLES, 1, 0, 0, 0},
+        {HISTORY_DAILY_SAMPLES, DAY_IN_HOURS, HISTORY_HOURLY_SAMPLES, 0, 0},
+        {HISTORY_MONTHLY_SAMPLES, DAY_IN_HOURS * HISTORY_MONTH_DAYS, HISTORY_HOURLY_SAMPLES + HISTORY_DAILY_SAMPLES, 0, 0},
+    },
+};
+
+static void accumulate(struct HistoryAccumulator *accumulator, const struct HistorySample *sample, int hours)
+{
+    if (accumulator->hours == 0 || sample->min < accumulator->min) accumulator->min = sample->min;
+    if (accumulator->hours == 0 || sample->max > accumulator->max) accumulator->max = sample->max;
+    accumulator->sum += (double)sample->mean * hours;
+    accumulator->hours += hours;
+}
+
+static struct HistorySample accumulated_sample(const struct HistoryAccumulator *accumulator)
+{
+    struct HistorySample sample = {accumulator->min, accumulator->max, (float)(accumulator->sum / accumulator->hours)};
+    return sample;
+}
+
+/**
+ * @brief Writes one sample per kingdom and metric into a level, then feeds the samples to
+ * the next level, which writes its own once it has gathered enough of them.
+ */
+static void push_samples(int level, struct HistorySample values[NUM_KINGDOMS][HISTORY_METRICS])
+{
+    struct HistoryLevel *ring = &history.levels[level];
+    for (int k = STARTING_ZERO; k < NUM_KINGDOMS; k++) {
+        for (int m = STARTING_ZERO; m < HISTORY_METRICS; m++) {
+            history.samples[k][m][ring->offset + ring->next] = values[k][m];
+        }
+    }
+    ring->next = (ring->next + STARTING_ONE) % ring->capacity;
+    if (ring->count < ring->capacity) ring->count++;
+
+    if (level + STARTING_ONE == HISTORY_LEVELS) return;
+    struct HistoryAccumulator (*pending)[HISTORY_METRICS] = history.pending[level + STARTING_ONE];
+    for (int k = STARTING_ZERO; k < NUM_KINGDOMS; k++) {
+        for (int m = STARTING_ZERO; m < HISTORY_METRICS; m++) {
+            accumulate(&pending[k][m], &values[k][m], ring->hours_per_sample);
+        }
+    }
+    if (pending[POSITION_ZERO][POSITION_ZERO].hours < history.levels[level + STARTING_ONE].hours_per_sample) return;
+
+    struct HistorySample merged[NUM_KINGDOMS][HISTORY_METRICS];
+    for (int k = STARTING_ZERO; k < NUM_KINGDOMS; k++) {
+        for (int m = STARTING_ZERO; m < HISTORY_METRICS; m++) {
+            merged[k][m] = accumulated_sample(&pending[k][m]);
+            pending[k][m].hours = STARTING_ZERO;
+            pending[k][m].sum = 0.0;
+        }
+    }
+    push_samples(level + STARTING_ONE, merged);
+}
+
+void history_record(const struct Kingdom kingdoms[], int hours)
+{
+    struct HistorySample values[NUM_KINGDOMS][HISTORY_METRICS];
+    for (int k = STARTING_ZERO; k < NUM_KINGDOMS; k++) {
+        float current[HISTORY_METRICS];
+        current[HISTORY_POPULATION] = (float)kingdoms[k].population;
+        current[HISTORY_UNREST] = (float)kingdoms[k].unrest_level;
+        current[HISTORY_TREASURY] = (float)kingdoms[k].treasury;
+        current[HISTORY_FOOD] = (float)kingdoms[k].food;
+        for (int m = STARTING_ZERO; m < HISTORY_METRICS; m++) {
+            values[k][m].min = values[k][m].max = values[k][m].mean = current[m];
+        }
+    }
+
+    pthread_mutex_lock(&history.mutex);
+    for (int h = STARTING_ZERO; h < hours; h++) push_samples(POSITION_ZERO, values);
+    history.recorded_hours += hours;
+    pthread_mutex_unlock(&history.mutex);
+}
+
+// A sample copied out for merging, with the hours it covers as its weight
+struct WeightedSample {
+    struct HistorySample sample;
+    int hours;
+};
+
+/**
+ * @brief Uses the finest level that still reaches back far enough. Its newest sample is the
+ * one still being filled, made from what the finer levels gathered since its last sample.
+ */
+int history_snapshot(int kingdom, enum HistoryMetric metric, int span_hours, int max_points, struct HistorySample out[])
+{
+    if (kingdom < STARTING_ZERO || kingdom >= NUM_KINGDOMS || metric < STARTING_ZERO || metric >= HISTORY_METRICS || max_points <= 0) return 0;
+
+    struct WeightedSample sources[HISTORY_TOTAL_SAMPLES + STARTING_ONE];
+    int source_count = STARTING_ZERO;
+
+    pthread_mutex_lock(&history.mutex);
+    long long span = history.recorded_hours;
+    if (span_hours > 0 && span_hours < span) span = span_hours;
+
+    for (int level = STARTING_ZERO; level < HISTORY_LEVELS && source_count == STARTING_ZERO; level++) {
+        const struct HistoryLevel *ring = &history.levels[level];
+        struct HistoryAccumulator partial = {0};
+        for (int finer = STARTING_ONE; finer <= level; finer++) {
+            const struct HistoryAccumulator *pending = &history.pending[finer][kingdom][metric];
+            if (pending->hours > 0) {
+                struct HistorySample part = accumulated_sample(pending);
+                accumulate(&partial, &part, pending->hours);
+            }
+        }
+        long long kept = (long long)ring->count * ring->hours_per_sample + partial.hours;
+        if (kept < span && level + STARTING_ONE < HISTORY_LEVELS) continue;
+
+        // Newest first while gathering; reversed below
+        long long covered = STARTING_ZERO;
+        if (partial.hours > 0) {
+            sources[source_count].sample = accumulated_sample(&partial);
+            sources[source_count++].hours = partial.hours;
+            covered += partial.hours;
+        }
+        for (int i = STARTING_ZERO; i < ring->count && covered < span; i++) {
+            int slot = (ring->next - STARTING_ONE - i + ring->capacity) % ring->capacity;
+            sources[source_count].sample = history.samples[kingdom][metric][ring->offset + slot];
+            sources[source_count++].hours = ring->hours_per_sample;
+            covered += ring->hours_per_sample;
+        }
+    }
+    pthread_mutex_unlock(&history.mutex);
+
+    for (int i = STARTING_ZERO; i < source_count / 2; i++) {
+        struct WeightedSample swap = sources[i];
+        sources[i] = sources[source_count - STARTING_ONE - i];
+        sources[source_count - STARTING_ONE - i] = swap;
+    }
+
+    // Neighbouring samples are merged so the result fits in max_points
+    int points = source_count < max_points ? source_count : max_points;
+    for (int p = STARTING_ZERO; p < points; p++) {
+        int first = (int)((long long)p * source_count / points);
+        int end = (int)((long long)(p + STARTING_ONE) * source_count / points);
+        struct HistoryAccumulator bucket = {0};
+        for (int s = first; s < end; s++) accumulate(&bucket, &sources[s].sample, sources[s].hours);
+        out[p] = accumulated_sample(&bucket);
+    }
+    return points;
+}
+
+const char *history_metric_name(enum HistoryMetric metric)
+{
+    switch (metric) {
+        case HISTORY_POPULATION: return "Population";
+        case HISTORY_UNREST: return "Unrest";
+        case HISTORY_TREASURY: return "Treasury";
+        case HISTORY_FOOD: return "Food";
+        default: return "Unknown";
+    }
+}
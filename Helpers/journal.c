@@ -0,0 +1,716 @@
+// file: journal.c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <pthread.h>
+#include "../journal.h"
+#include "../game_config.h"
+#include "../logger.h"
+#include "../rng.h"
+#include "../cohorts.h"
+#include "../lifecycle.h"
+#include "../forced_story.h"
+#include "../governor.h"
+
+enum JournalRecordType {
+    JOURNAL_STORY = 1,      // Two int32: chapter, paragraph
+    JOURNAL_COMMAND,        // int32: a PlayerCommand
+    JOURNAL_WORK_SLICE,     // int32: humans in the hour's work slice
+    JOURNAL_CHECKSUM,       // uint64: the world at midnight
+    JOURNAL_KEYFRAME,       // The simulation's whole state, see write_keyframe
+    JOURNAL_PLAN,           // Two int32: kingdom, the planning governor's GovernorAction
+    JOURNAL_WAIT,           // Nothing: the night's fast-forward waited for the player
+    JOURNAL_RECORD_TYPES
+};
+
+struct JournalHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t keyframe_days;
+    uint64_t seed;
+    uint64_t config_hash;
+    uint32_t cohorts;
+    uint32_t unused;
+};
+
+// Every record starts with this, followed by `size` bytes
+struct JournalRecord {
+    uint32_t type;
+    uint32_t size;
+    int64_t tick;
+};
+
+// A replayed record. Keyframes keep where their contents start in the file.
+struct JournalEvent {
+    long long tick;
+    int32_t values[2];
+    uint64_t checksum;
+    long offset;
+    uint32_t size;
+};
+
+struct JournalEvents {
+    struct JournalEvent *items;
+    int count;
+    int capacity;
+    int next; // First one not replayed yet
+};
+
+enum JournalMode { JOURNAL_OFF, JOURNAL_RECORDING, JOURNAL_REPLAYING };
+
+static struct {
+    pthread_mutex_t mutex;
+    enum JournalMode mode;
+    FILE *file;
+    uint32_t keyframe_days;
+    long long tick;              // The hour being simulated
+    int story_chapter;           // Recording: last position written. Replaying: position to use.
+    int story_paragraph;
+    struct JournalEvents events[JOURNAL_RECORD_TYPES];
+    long long last_tick;         // Replaying: tick of the journal's last record
+    long long catch_up_until;    // Replaying: hours before this tick are simulated without pausing
+    int matched_days;
+    bool diverged;
+} journal = { .mutex = PTHREAD_MUTEX_INITIALIZER };
+
+// Names in the details table restored from keyframes. They live until the game ends.
+static const char **interned_names;
+static int interned_count;
+
+static uint64_t hash_bytes(uint64_t hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < size; i++) hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    return hash;
+}
+
+/**
+ * @brief FNV-1a over the running executable. The game's settings are compiled in from
+ * game_config.h, so a different build or different settings give a different hash.
+ */
+static uint64_t config_hash(void)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    FILE *file = fopen("/proc/self/exe", "rb");
+    if (file == NULL) return 0;
+    unsigned char buffer[65536];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) hash = hash_bytes(hash, buffer, read);
+    fclose(file);
+    return hash;
+}
+
+/**
+ * @brief Fingerprints the world: every citizen, the kingdoms' stocks and the random stream.
+ * Only fields are hashed, never whole structs, so padding can't make two equal worlds differ.
+ */
+static uint64_t world_checksum(const struct Kingdom kingdoms[], const struct HumanPopulation *world_stat, const struct Human_Data *data)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (int k = 0; k < NUM_KINGDOMS; k++) {
+        const struct Kingdom *kingdom = &kingdoms[k];
+        long long values[] = {kingdom->is_active, kingdom->population, kingdom->unrest_level, kingdom->food, kingdom->wood,
+                              kingdom->stone, kingdom->metal, kingdom->weapons, kingdom->treasury, kingdom->army_morale};
+        hash = hash_bytes(hash, values, sizeof(values));
+    }
+    hash = hash_bytes(hash, &world_stat->human_population, sizeof(world_stat->human_population));
+    hash = hash_bytes(hash, &data->count, sizeof(data->count));
+    hash = hash_bytes(hash, data->humans, (size_t)data->count * sizeof(struct Human_Stats)); // Only ints, no padding
+    hash = hash_bytes(hash, g_sim_rng.lanes, sizeof(g_sim_rng.lanes));
+    hash = hash_bytes(hash, &g_sim_rng.next_lane, sizeof(g_sim_rng.next_lane));
+    return hash;
+}
+
+// --- Writing ---
+
+static bool write_record(uint32_t type, long long tick, const void *payload, uint32_t size)
+{
+    struct JournalRecord record = {type, size, tick};
+    return fwrite(&record, sizeof(record), 1, journal.file) == 1 &&
+           (size == 0 || fwrite(payload, size, 1, journal.file) == 1);
+}
+
+static bool put(const void *data, size_t size)
+{
+    return size == 0 || fwrite(data, size, 1, journal.file) == 1;
+}
+
+static int name_index(const char *name, const char *names[], int *count, int max)
+{
+    if (name == NULL) return -1;
+    for (int i = 0; i < *count; i++) {
+        if (names[i] == name || strcmp(names[i], name) == 0) return i;
+    }
+    if (*count == max) return -1;
+    names[*count] = name;
+    return (*count)++;
+}
+
+/**
+ * @brief Writes a keyframe: the clock, the story's one-shot effects, the random stream, the
+ * kingdoms, the population with its details table, the calendar of deaths and the cohorts.
+ * Pointers in the structs are written too but ignored on reading; what they point to follows.
+ * The record's size is patched in once everything is written.
+ */
+static bool write_keyframe(const struct JournalClock *clock, const struct Kingdom kingdoms[],
+                           const struct HumanPopulation *world_stat, const struct Human_Data *data)
+{
+    long start = ftell(journal.file);
+    if (start < 0 || !write_record(JOURNAL_KEYFRAME, JOURNAL_TICK(clock->day, clock->hour), NULL, 0)) return false;
+
+    int story_effects[STORY_EFFECT_COUNT];
+    get_story_effects_fired(story_effects);
+    bool written = put(clock, sizeof(*clock)) && put(story_effects, sizeof(story_effects)) &&
+                   put(&g_sim_rng, sizeof(g_sim_rng)) && put(kingdoms, NUM_KINGDOMS * sizeof(struct Kingdom)) &&
+                   put(world_stat, sizeof(*world_stat)) && put(data, sizeof(*data)) &&
+                   put(data->humans, (size_t)data->count * sizeof(struct Human_Stats));
+
+    // Details: the entries, then their names as indices into a table of the distinct names
+    enum { MAX_NAMES = 64 };
+    const char *names[MAX_NAMES];
+    int name_count = 0;
+    for (int i = 0; written && i < data->details_count; i++) {
+        // Entry 0 and free entries are never read, and entry 0 was never even written
+        bool in_use = i > 0 && data->details[i].owner >= 0;
+        int32_t name = in_use ? name_index(data->details[i].name, names, &name_count, MAX_NAMES) : -1;
+        written = put(&data->details[i], sizeof(struct Human_Details)) && put(&name, sizeof(name));
+    }
+    written = written && put(&name_count, sizeof(name_count));
+    for (int i = 0; written && i < name_count; i++) {
+        uint32_t length = (uint32_t)strlen(names[i]);
+        written = put(&length, sizeof(length)) && put(names[i], length);
+    }
+
+    written = written && put(&g_life_calendar, sizeof(g_life_calendar));
+    for (int b = 0; written && b < LIFE_CALENDAR_DAYS; b++) {
+        written = put(g_life_calendar.buckets[b].indices, (size_t)g_life_calendar.buckets[b].count * sizeof(int));
+    }
+    written = written && put(&g_cohorts, sizeof(g_cohorts));
+
+    long end = ftell(journal.file);
+    if (!written || end < 0) return false;
+    uint32_t size = (uint32_t)(end - start - (long)sizeof(struct JournalRecord));
+    return fseek(journal.file, start + (long)offsetof(struct JournalRecord, size), SEEK_SET) == 0 &&
+           fwrite(&size, sizeof(size), 1, journal.file) == 1 && fseek(journal.file, end, SEEK_SET) == 0;
+}
+
+/**
+ * @brief Stops recording after a failed write; the run itself goes on.
+ */
+static void recording_failed(void)
+{
+    fprintf(stderr, "Error: Could not write to the replay journal. Recording stops here.\n");
+    fclose(journal.file);
+    journal.file = NULL;
+    journal.mode = JOURNAL_OFF;
+}
+
+/**
+ * @brief Starts a new journal at `path`, replacing any old one.
+ */
+bool journal_record(const char *path, uint64_t seed, bool cohorts)
+{
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Error: Could not create the replay journal '%s'.\n", path);
+        return false;
+    }
+    struct JournalHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+    header.version = JOURNAL_VERSION;
+    header.keyframe_days = JOURNAL_KEYFRAME_DAYS;
+    header.seed = seed;
+    header.config_hash = config_hash();
+    header.cohorts = cohorts;
+    if (fwrite(&header, sizeof(header), 1, file) != 1) {
+        fprintf(stderr, "Error: Could not write the replay journal '%s'.\n", path);
+        fclose(file);
+        return false;
+    }
+
+    pthread_mutex_lock(&journal.mutex);
+    journal.file = file;
+    journal.mode = JOURNAL_RECORDING;
+    journal.keyframe_days = header.keyframe_days;
+    journal.story_chapter = journal.story_paragraph = 0;
+    pthread_mutex_unlock(&journal.mutex);
+    printf("Recording the run to '%s' (seed %llu).\n", path, (unsigned long long)seed);
+    return true;
+}
+
+// --- Reading ---
+
+static bool add_event(int type, const struct JournalEvent *event)
+{
+    struct JournalEvents *list = &journal.events[type];
+    if (list->count == list->capacity) {
+        int new_capacity = list->capacity > 0 ? list->capacity * 2 : 256;
+        struct JournalEvent *grown = realloc(list->items, new_capacity * sizeof(*grown));
+        if (grown == NULL) {
+            fprintf(stderr, "Error: Failed to allocate memory for the replay journal.\n");
+            return false;
+        }
+        list->items = grown;
+        list->capacity = new_capacity;
+    }
+    list->items[list->count++] = *event;
+    return true;
+}
+
+/**
+ * @brief Reads the journal's small records into memory and notes where the keyframes are.
+ * A journal cut short by a crash replays up to its last whole record.
+ */
+static bool read_records(FILE *file)
+{
+    struct JournalRecord record;
+    while (fread(&record, sizeof(record), 1, file) == 1) {
+        struct JournalEvent event;
+        memset(&event, 0, sizeof(event));
+        event.tick = record.tick;
+        event.offset = ftell(file);
+        event.size = record.size;
+
+        bool whole;
+        if (record.type == JOURNAL_KEYFRAME) {
+            // The size is filled in once the keyframe is complete
+            whole = record.size > 0 && fseek(file, record.size, SEEK_CUR) == 0 && ftell(file) - event.offset == (long)record.size;
+            // fseek happily moves past the end, so check the keyframe's last byte is there
+            if (whole && record.size > 0) {
+                whole = fseek(file, -1, SEEK_CUR) == 0 && fgetc(file) != EOF;
+            }
+        } else if (record.type == JOURNAL_CHECKSUM && record.size == sizeof(event.checksum)) {
+            whole = fread(&event.checksum, sizeof(event.checksum), 1, file) == 1;
+        } else if (record.type > 0 && record.type < JOURNAL_RECORD_TYPES && record.size <= sizeof(event.values)) {
+            whole = fread(event.values, record.size, 1, file) == 1 || record.size == 0;
+        } else {
+            fprintf(stderr, "Error: The replay journal has an unknown record (type %u).\n", record.type);
+            return false;
+        }
+        if (!whole) {
+            fprintf(stderr, "Warning: The replay journal ends in the middle of a record. Replaying up to it.\n");
+            break;
+        }
+        if (!add_event((int)record.type, &event)) return false;
+        journal.last_tick = record.tick;
+    }
+    return true;
+}
+
+/**
+ * @brief Opens a journal to replay, and hands back the seed and mode the run was recorded with.
+ */
+bool journal_replay(const char *path, uint64_t *seed, bool *cohorts)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Error: Could not open the replay journal '%s'.\n", path);
+        return false;
+    }
+    struct JournalHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, JOURNAL_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != JOURNAL_VERSION) {
+        fprintf(stderr, "Error: '%s' is not a replay journal of this version.\n", path);
+        fclose(file);
+        return false;
+    }
+    if (header.config_hash != config_hash()) {
+        fprintf(stderr, "Warning: '%s' was recorded by another build or with other settings. The replay may not match.\n", path);
+    }
+
+    pthread_mutex_lock(&journal.mutex);
+    journal.file = file;
+    journal.keyframe_days = header.keyframe_days;
+    journal.story_chapter = journal.story_paragraph = 0;
+    bool read = read_records(file);
+    if (read) journal.mode = JOURNAL_REPLAYING;
+    pthread_mutex_unlock(&journal.mutex);
+    if (!read) {
+        journal_close();
+        return false;
+    }
+
+    *seed = header.seed;
+    *cohorts = header.cohorts != 0;
+    printf("Replaying '%s' (seed %llu) up to day %lld.\n", path, (unsigned long long)header.seed, journal.last_tick / DAY_IN_HOURS);
+    return true;
+}
+
+bool journal_replaying(void)
+{
+    pthread_mutex_lock(&journal.mutex);
+    bool replaying = journal.mode == JOURNAL_REPLAYING;
+    pthread_mutex_unlock(&journal.mutex);
+    return replaying;
+}
+
+void journal_close(void)
+{
+    pthread_mutex_lock(&journal.mutex);
+    if (journal.file != NULL) fclose(journal.file);
+    journal.file = NULL;
+    journal.mode = JOURNAL_OFF;
+    for (int type = 0; type < JOURNAL_RECORD_TYPES; type++) {
+        free(journal.events[type].items);
+        memset(&journal.events[type], 0, sizeof(journal.events[type]));
+    }
+    pthread_mutex_unlock(&journal.mutex);
+}
+
+// --- Every hour ---
+
+// The next recorded event of a type at `tick`, or NULL. Events before `tick` were missed by a seek.
+static const struct JournalEvent *take_event(int type, long long tick)
+{
+    struct JournalEvents *list = &journal.events[type];
+    while (list->next < list->count && list->items[list->next].tick < tick) list->next++;
+    if (list->next == list->count || list->items[list->next].tick != tick) return NULL;
+    return &list->items[list->next++];
+}
+
+/**
+ * @brief Ends the replay once the run has passed the journal's last record. From then on
+ * the world runs live and takes the player's orders again.
+ */
+void journal_begin_hour(long long tick)
+{
+    pthread_mutex_lock(&journal.mutex);
+    journal.tick = tick;
+    if (journal.mode == JOURNAL_REPLAYING && tick > journal.last_tick) {
+        if (journal.diverged) {
+            log_event("The replay has reached the end of the journal. It did not match the recorded run.");
+        } else {
+            log_event("The replay has reached the end of the journal, matching all %d recorded days.", journal.matched_days);
+        }
+        printf("Replay finished on day %lld; %d days matched the recording%s.\n", tick / DAY_IN_HOURS,
+               journal.matched_days, journal.diverged ? ", then it diverged" : "");
+        fclose(journal.file);
+        journal.file = NULL;
+        journal.mode = JOURNAL_OFF;
+    }
+    pthread_mutex_unlock(&journal.mutex);
+}
+
+/**
+ * @brief Recording: writes the story position down when it changed.
+ * Replaying: replaces it with the recorded one.
+ */
+void journal_story_position(long long tick, int *chapter, int *paragraph)
+{
+    pthread_mutex_lock(&journal.mutex);
+    if (journal.mode == JOURNAL_RECORDING && (*chapter != journal.story_chapter || *paragraph != journal.story_paragraph)) {
+        int32_t position[2] = {*chapter, *paragraph};
+        if (write_record(JOURNAL_STORY, tick, position, sizeof(position))) {
+            journal.story_chapter = *chapter;
+            journal.story_paragraph = *paragraph;
+        } else {
+            recording_failed();
+        }
+    } else if (journal.mode == JOURNAL_REPLAYING) {
+        const struct JournalEvent *event;
+        while ((event = take_event(JOURNAL_STORY, tick)) != NULL) {
+            journal.story_chapter = event->values[0];
+            journal.story_paragraph = event->values[1];
+        }
+        *chapter = journal.story_chapter;
+        *paragraph = journal.story_paragraph;
+    }
+    pthread_mutex_unlock(&journal.mutex);
+}
+
+/**
+ * @brief Recording: writes down the player's `count` orders for this hour.
+ * Replaying: replaces them with the recorded ones. Returns how many to carry out.
+ */
+int journal_player_commands(long long tick, int commands[], int count, int max)
+{
+    pthread_mutex_lock(&journal.mutex);
+    if (journal.mode == JOURNAL_RECORDING) {
+        for (int i = 0; i < count; i++) {
+            int32_t command = commands[i];
+            if (!write_record(JOURNAL_COMMAND, tick, &command, sizeof(command))) {
+                recording_failed();
+                break;
+            }
+        }
+        if (count > 0 && journal.file != NULL) fflush(journal.file); // Orders are rare and what a replay needs most
+    } else if (journal.mode == JOURNAL_REPLAYING) {
+        const struct JournalEvent *event;
+        count = 0;
+        while (count < max && (event = take_event(JOURNAL_COMMAND, tick)) != NULL) commands[count++] = event->values[0];
+    }
+    pthread_mutex_unlock(&journal.mutex);
+    return count;
+}
+
+/**
+ * @brief Recording: writes down the size of this hour's work slice.
+ * Replaying: sets it to the recorded size and returns true.
+ */
+bool journal_work_slice(long long tick, int *slice_size)
+{
+    bool replayed = false;
+    pthread_mutex_lock(&journal.mutex);
+    if (journal.mode == JOURNAL_RECORDING && *slice_size > 0) {
+        int32_t size = *slice_size;
+        if (!write_record(JOURNAL_WORK_SLICE, tick, &size, sizeof(size))) recording_failed();
+    } else if (journal.mode == JOURNAL_REPLAYING) {
+        const struct JournalEvent *event = take_event(JOURNAL_WORK_SLICE, tick);
+        *slice_size = (event != NULL) ? event->values[0] : 0;
+        replayed = true;
+    }
+    pthread_mutex_unlock(&journal.mutex);
+    return replayed;
+}
+
+/**
+ * @brief Recording: writes down that the player's input was waiting, if it was.
+ * Replaying: returns whether it was waiting in the recorded run.
+ */
+bool journal_player_waiting(long long tick, bool waiting)
+{
+    pthread_mutex_lock(&journal.mutex);
+    if (journal.mode == JOURNAL_RECORDING && waiting) {
+        if (!write_record(JOURNAL_WAIT, tick, NULL, 0)) recording_failed();
+    } else if (journal.mode == JOURNAL_REPLAYING) {
+        waiting = take_event(JOURNAL_WAIT, tick) != NULL;
+    }
+    pthread_mutex_unlock(&journal.mutex);
+    return waiting;
+}
+
+/**
+ * @brief Replaying: returns true with the governor's recorded choice for this kingdom, or
+ * with GOVERNOR_USE_HEURISTIC when the recording has none.
+ */
+bool journal_replayed_plan(int kingdom, int *action)
+{
+    bool replayed = false;
+    pthread_mutex_lock(&journal.mutex);
+    if (journal.mode == JOURNAL_REPLAYING) {
+        const struct JournalEvent *event = take_event(JOURNAL_PLAN, journal.tick);
+        *action = (event != NULL && event->values[0] == kingdom) ? event->values[1] : GOVERNOR_USE_HEURISTIC;
+        replayed = true;
+    }
+    pthread_mutex_unlock(&journal.mutex);
+    return replayed;
+}
+
+/**
+ * @brief Recording: writes down the governor's choice for this kingdom.
+ */
+void journal_plan(int kingdom, int action)
+{
+    pthread_mutex_lock(&journal.mutex);
+    if (journal.mode == JOURNAL_RECORDING) {
+        int32_t plan[2] = {kingdom, action};
+        if (!write_record(JOURNAL_PLAN, journal.tick, plan, sizeof(plan))) recording_failed();
+    }
+    pthread_mutex_unlock(&journal.mutex);
+}
+
+/**
+ * @brief Recording: writes the day's checksum, a keyframe every keyframe_days days, and
+ * flushes the journal. Replaying: compares the world with the recorded checksum.
+ */
+void journal_end_of_day(const struct JournalClock *clock, const struct Kingdom kingdoms[],
+                        const struct HumanPopulation *world_stat, const struct Human_Data *data)
+{
+    pthread_mutex_lock(&journal.mutex);
+    long long tick = JOURNAL_TICK(clock->day, clock->hour);
+    if (journal.mode == JOURNAL_RECORDING) {
+        uint64_t checksum = world_checksum(kingdoms, world_stat, data);
+        bool written = write_record(JOURNAL_CHECKSUM, tick, &checksum, sizeof(checksum));
+        if (written && journal.keyframe_days > 0 && clock->day % journal.keyframe_days == 0) {
+            written = write_keyframe(clock, kingdoms, world_stat, data);
+        }
+        if (!written || fflush(journal.file) != 0) recording_failed();
+    } else if (journal.mode == JOURNAL_REPLAYING) {
+        const struct JournalEvent *event = take_event(JOURNAL_CHECKSUM, tick);
+        if (event != NULL && !journal.diverged) {
+            if (event->checksum == world_checksum(kingdoms, world_stat, data)) {
+                journal.matched_days++;
+            } else {
+                journal.diverged = true;
+                log_event("The replay no longer matches the recorded run (day %d).", clock->day);
+                fprintf(stderr, "Warning: The replay diverged from the journal on day %d.\n", clock->day);
+            }
+        }
+    }
+    pthread_mutex_unlock(&journal.mutex);
+}
+
+// --- Seeking ---
+
+static bool get(FILE *file, void *data, size_t size)
+{
+    return size == 0 || fread(data, size, 1, file) == 1;
+}
+
+static const char *intern_name(const char *name)
+{
+    for (int i = 0; i < interned_count; i++) {
+        if (strcmp(interned_names[i], name) == 0) return interned_names[i];
+    }
+    const char **grown = realloc(interned_names, (interned_count + 1) * sizeof(*grown));
+    char *copy = strdup(name);
+    if (grown == NULL || copy == NULL) {
+        free(copy);
+        if (grown != NULL) interned_names = grown;
+        return "Adam";
+    }
+    interned_names = grown;
+    interned_names[interned_count++] = copy;
+    return copy;
+}
+
+/**
+ * @brief Reads a keyframe written by write_keyframe over the current world.
+ * The world is only changed once the whole keyframe has been read.
+ */
+static bool read_keyframe(const struct JournalEvent *keyframe, struct JournalClock *clock, struct Kingdom kingdoms[],
+                          struct HumanPopulation *world_stat, struct Human_Data *data)
+{
+    FILE *file = journal.file;
+    if (fseek(file, keyframe->offset, SEEK_SET) != 0) return false;
+
+    struct JournalClock read_clock;
+    int story_effects[STORY_EFFECT_COUNT];
+    struct RngStream rng;
+    struct Kingdom read_kingdoms[NUM_KINGDOMS];
+    struct HumanPopulation read_world;
+    struct Human_Data read_data;
+    if (!get(file, &read_clock, sizeof(read_clock)) || !get(file, story_effects, sizeof(story_effects)) ||
+        !get(file, &rng, sizeof(rng)) || !get(file, read_kingdoms, sizeof(read_kingdoms)) ||
+        !get(file, &read_world, sizeof(read_world)) || !get(file, &read_data, sizeof(read_data))) return false;
+    if (read_data.count < 0 || read_data.count > read_data.capacity || read_data.details_count < 0 ||
+        read_data.details_count > read_data.details_capacity) return false;
+
+    // Keyframes are only read once per run, so plain allocations are fine here
+    struct Human_Stats *humans = malloc((read_data.capacity > 0 ? read_data.capacity : 1) * sizeof(struct Human_Stats));
+    struct Human_Details *details = calloc(read_data.details_capacity > 0 ? read_data.details_capacity : 1, sizeof(struct Human_Details));
+    int32_t *name_indices = malloc((read_data.details_count > 0 ? read_data.details_count : 1) * sizeof(int32_t));
+    struct LifeCalendar calendar;
+    struct CohortPopulation *cohorts = malloc(sizeof(*cohorts));
+    int *bucket_indices[LIFE_CALENDAR_DAYS] = {NULL};
+    bool read = humans != NULL && details != NULL && name_indices != NULL && cohorts != NULL &&
+                get(file, humans, (size_t)read_data.count * sizeof(struct Human_Stats));
+
+    for (int i = 0; read && i < read_data.details_count; i++) {
+        read = get(file, &details[i], sizeof(struct Human_Details)) && get(file, &name_indices[i], sizeof(int32_t));
+    }
+    int name_count = 0;
+    read = read && get(file, &name_count, sizeof(name_count)) && name_count >= 0 && name_count <= 64;
+    const char *names[64];
+    for (int n = 0; read && n < name_count; n++) {
+        uint32_t length;
+        char name[256];
+        read = get(file, &length, sizeof(length)) && length < sizeof(name) && get(file, name, length);
+        if (read) {
+            name[length] = '\0';
+            names[n] = intern_name(name);
+        }
+    }
+    for (int i = 0; read && i < read_data.details_count; i++) {
+        read = name_indices[i] < name_count;
+        details[i].name = (name_indices[i] >= 0 && read) ? names[name_indices[i]] : NULL;
+    }
+
+    read = read && get(file, &calendar, sizeof(calendar));
+    for (int b = 0; read && b < LIFE_CALENDAR_DAYS; b++) {
+        int count = calendar.buckets[b].count;
+        bucket_indices[b] = malloc((count > 0 ? count : 1) * sizeof(int));
+        read = count >= 0 && bucket_indices[b] != NULL && get(file, bucket_indices[b], (size_t)count * sizeof(int));
+    }
+    read = read && get(file, cohorts, sizeof(*cohorts));
+    free(name_indices);
+    if (!read) {
+        free(humans);
+        free(details);
+        free(cohorts);
+        for (int b = 0; b < LIFE_CALENDAR_DAYS; b++) free(bucket_indices[b]);
+        return false;
+    }
+
+    // Everything is in; swap it in for the world generated at startup
+    *clock = read_clock;
+    set_story_effects_fired(story_effects);
+    g_sim_rng = rng;
+    for (int k = 0; k < NUM_KINGDOMS; k++) {
+        const char *name = kingdoms[k].name; // Same kingdoms, same names
+        kingdoms[k] = read_kingdoms[k];
+        kingdoms[k].name = name;
+    }
+    *world_stat = read_world;
+    free(data->humans);
+    free(data->details);
+    read_data.humans = humans;
+    read_data.details = details;
+    read_data.scratch = data->scratch; // Nothing in the scratch buffer outlives a pass
+    read_data.scratch_capacity = data->scratch_capacity;
+    *data = read_data;
+    for (int b = 0; b < LIFE_CALENDAR_DAYS; b++) {
+        free(g_life_calendar.buckets[b].indices);
+        calendar.buckets[b].indices = bucket_indices[b];
+        calendar.buckets[b].capacity = calendar.buckets[b].count > 0 ? calendar.buckets[b].count : 1;
+    }
+    g_life_calendar = calendar;
+    g_cohorts = *cohorts;
+    free(cohorts);
+    return true;
+}
+
+/**
+ * @brief Loads the last keyframe before `day` and sets the replay to run without pausing
+ * until the start of `day`. Without a keyframe the replay catches up from the first hour.
+ * @return true if a keyframe was loaded; `clock` and the world then hold its state.
+ */
+bool journal_seek(int day, struct JournalClock *clock, struct Kingdom kingdoms[],
+                  struct HumanPopulation *world_stat, struct Human_Data *data)
+{
+    pthread_mutex_lock(&journal.mutex);
+    if (journal.mode != JOURNAL_REPLAYING) {
+        pthread_mutex_unlock(&journal.mutex);
+        return false;
+    }
+    journal.catch_up_until = JOURNAL_TICK(day, 0);
+
+    const struct JournalEvents *keyframes = &journal.events[JOURNAL_KEYFRAME];
+    int chosen = -1;
+    for (int i = 0; i < keyframes->count && keyframes->items[i].tick <= journal.catch_up_until; i++) chosen = i;
+    bool loaded = chosen >= 0 && read_keyframe(&keyframes->items[chosen], clock, kingdoms, world_stat, data);
+    if (chosen >= 0 && !loaded) {
+        fprintf(stderr, "Error: The keyframe for day %lld is damaged. Replaying from the start.\n",
+                keyframes->items[chosen].tick / DAY_IN_HOURS);
+    }
+    if (loaded) {
+        // Everything recorded before the keyframe is already part of it
+        long long tick = keyframes->items[chosen].tick;
+        for (int type = 0; type < JOURNAL_RECORD_TYPES; type++) {
+            struct JournalEvents *list = &journal.events[type];
+            while (list->next < list->count && list->items[list->next].tick < tick) list->next++;
+        }
+        // The keyframe was written after the day's checksum, which it therefore matches
+        struct JournalEvents *checksums = &journal.events[JOURNAL_CHECKSUM];
+        if (checksums->next < checksums->count && checksums->items[checksums->next].tick == tick) checksums->next++;
+        journal.story_chapter = clock->story_chapter;
+        journal.story_paragraph = clock->story_paragraph;
+        printf("Seeking: loaded the keyframe of day %d, simulating on to day %d.\n", clock->day, day);
+    }
+    pthread_mutex_unlock(&journal.mutex);
+    return loaded;
+}
+
+/**
+ * @brief True while a seek is still simulating its way to the day asked for.
+ */
+bool journal_catching_up(long long tick)
+{
+    pthread_mutex_lock(&journal.mutex);
+    bool catching_up = journal.mode == JOURNAL_REPLAYING && tick < journal.catch_up_until;
+    pthread_mutex_unlock(&journal.mutex);
+    return catching_up;
+}
@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdarg.h>
+#include <stdbool.h>
 #include "../logger.h"
 
 // Definition of the global variables from the header
@@ -10,6 +11,8 @@ LogEntry g_log_entries[MAX_LOG_ENTRIES];
 pthread_mutex_t g_event_log_mutex;
 int g_log_write_index = 0;
 int g_log_read_index = 0; // Start both at the same place
+unsigned long g_log_sequence = 0;
+unsigned int g_log_expiry_generation = 0;
 
 void init_logger(void) {
     if (pthread_mutex_init(&g_event_log_mutex, NULL) != 0) {
@@ -58,6 +61,7 @@ void log_multiline_event(const char *report_string) {
 
             // Advance the write index for the next message.
             g_log_write_index = (write_idx + 1) % MAX_LOG_ENTRIES;
+            g_log_sequence++;
         }
         
         // Move the start pointer to the beginning of the next line.
@@ -71,6 +75,7 @@ void log_multiline_event(const char *report_string) {
         g_log_entries[write_idx].message[LOG_MESSAGE_LENGTH - 1] = '\0'; // Ensure null termination
         g_log_entries[write_idx].timestamp = time(NULL);
         g_log_write_index = (write_idx + 1) % MAX_LOG_ENTRIES;
+        g_log_sequence++;
     }
 
     // Unlock the mutex now that the entire operation is complete.
@@ -98,6 +103,7 @@ void log_event(const char* format, ...) {
 
     // Move the write index to the next spot, wrapping around if necessary
     g_log_write_index = (g_log_write_index + 1) % MAX_LOG_ENTRIES;
+    g_log_sequence++;
 
     // IMPORTANT: If the write index has caught up to the read index, it means
     // we have overwritten an unread message. We must push the read index forward
@@ -114,6 +120,7 @@ void clear_old_log_entries(void) {
     pthread_mutex_lock(&g_event_log_mutex);
 
     time_t now = time(NULL);
+    bool cleared = false;
 
     for (int i = 0; i < MAX_LOG_ENTRIES; i++) {
         // Check if the message is valid (timestamp > 0) and old
@@ -121,8 +128,10 @@ void clear_old_log_entries(void) {
             // "Clear" the message by setting its timestamp to 0.
             // We don't need to erase the text, this is faster.
             g_log_entries[i].timestamp = 0;
+            cleared = true;
         }
     }
+    if (cleared) g_log_expiry_generation++;
 
     pthread_mutex_unlock(&g_event_log_mutex);
 }
\ No newline at end of file
@@ -0,0 +1,91 @@
+// file: rng.c
+
+#include "../rng.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+static inline uint32_t xorshift32(uint32_t x) {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+// splitmix64, only used to spread one seed over all the lanes.
+static uint64_t splitmix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void rng_seed(struct RngStream *rng, uint64_t seed) {
+    uint64_t state = seed;
+    for (int i = 0; i < RNG_LANES; i++) {
+        uint32_t lane = (uint32_t)splitmix64(&state);
+        rng->lanes[i] = (lane != 0) ? lane : 0x6D2B79F5u; // xorshift must never hold 0
+    }
+    rng->next_lane = 0;
+}
+
+uint32_t rng_next(struct RngStream *rng) {
+    int lane = rng->next_lane;
+    rng->lanes[lane] = xorshift32(rng->lanes[lane]);
+    rng->next_lane = (lane + 1) % RNG_LANES;
+    return rng->lanes[lane];
+}
+
+/**
+ * @brief Writes `count` random numbers to `out`.
+ * Whole rounds of RNG_LANES numbers are generated with vector instructions when available.
+ */
+void rng_fill(struct RngStream *rng, uint32_t *out, int count) {
+    int i = 0;
+
+    // Finish the current round one lane at a time so the vector loop starts at lane 0.
+    while (i < count && rng->next_lane != 0) {
+        out[i++] = rng_next(rng);
+    }
+
+#if defined(__AVX2__)
+    __m256i x = _mm256_loadu_si256((const __m256i *)rng->lanes);
+    for (; i + RNG_LANES <= count; i += RNG_LANES) {
+        x = _mm256_xor_si256(x, _mm256_slli_epi32(x, 13));
+        x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 17));
+        x = _mm256_xor_si256(x, _mm256_slli_epi32(x, 5));
+        _mm256_storeu_si256((__m256i *)&out[i], x);
+    }
+    _mm256_storeu_si256((__m256i *)rng->lanes, x);
+#elif defined(__SSE2__)
+    __m128i lo = _mm_loadu_si128((const __m128i *)&rng->lanes[0]);
+    __m128i hi = _mm_loadu_si128((const __m128i *)&rng->lanes[4]);
+    for (; i + RNG_LANES <= count; i += RNG_LANES) {
+        lo = _mm_xor_si128(lo, _mm_slli_epi32(lo, 13));
+        hi = _mm_xor_si128(hi, _mm_slli_epi32(hi, 13));
+        lo = _mm_xor_si128(lo, _mm_srli_epi32(lo, 17));
+        hi = _mm_xor_si128(hi, _mm_srli_epi32(hi, 17));
+        lo = _mm_xor_si128(lo, _mm_slli_epi32(lo, 5));
+        hi = _mm_xor_si128(hi, _mm_slli_epi32(hi, 5));
+        _mm_storeu_si128((__m128i *)&out[i], lo);
+        _mm_storeu_si128((__m128i *)&out[i + 4], hi);
+    }
+    _mm_storeu_si128((__m128i *)&rng->lanes[0], lo);
+    _mm_storeu_si128((__m128i *)&rng->lanes[4], hi);
+#else
+    for (; i + RNG_LANES <= count; i += RNG_LANES) {
+        for (int lane = 0; lane < RNG_LANES; lane++) {
+            rng->lanes[lane] = xorshift32(rng->lanes[lane]);
+            out[i + lane] = rng->lanes[lane];
+        }
+    }
+#endif
+
+    // Leftovers
+    while (i < count) {
+        out[i++] = rng_next(rng);
+    }
+}
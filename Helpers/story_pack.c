@@ -0,0 +1,241 @@
+// file: story_pack.c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include "../story_pack.h"
+
+#define DAMAGED_TEXT "[This part of the story pack is damaged. Pack the story again.]"
+
+enum { SECTION_UNCHECKED, SECTION_INTACT, SECTION_DAMAGED };
+
+// The mapped pack. Written once at startup, then only read, so both threads may use it.
+// The checksum state of the sections is guarded by sections_mutex.
+static struct {
+    const char *base;
+    size_t size;
+    const struct StoryPackHeader *header;
+    const struct StoryPackChapter *chapters;
+    const struct StoryPackParagraph *paragraphs;
+    const uint32_t *perspectives;
+    const struct StoryPackCharacter *characters;
+    const char *text;
+    unsigned char *sections;     // Checksum state of every chapter, then of the text after them
+} pack;
+
+static pthread_mutex_t sections_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static uint64_t hash_bytes(uint64_t hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < size; i++) hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    return hash;
+}
+
+static bool table_fits(uint32_t at, uint32_t count, size_t entry_size, size_t file_size)
+{
+    return at <= file_size && (size_t)count <= (file_size - at) / entry_size;
+}
+
+/**
+ * @brief Checks the tables' checksum, then every table entry against the file, so the getters
+ * never read outside it. Only the tables are read here; the text is paged in, and checked,
+ * when it is shown.
+ */
+static bool pack_is_valid(void)
+{
+    const struct StoryPackHeader *header = pack.header;
+    if (memcmp(header->magic, STORY_PACK_MAGIC, sizeof(header->magic)) != 0 || header->version != STORY_PACK_VERSION) return false;
+    if (!table_fits(header->chapters_at, header->chapter_count, sizeof(struct StoryPackChapter), pack.size) ||
+        !table_fits(header->paragraphs_at, header->paragraph_count, sizeof(struct StoryPackParagraph), pack.size) ||
+        !table_fits(header->perspectives_at, header->perspective_count, sizeof(uint32_t), pack.size) ||
+        !table_fits(header->characters_at, header->character_count, sizeof(struct StoryPackCharacter), pack.size) ||
+        !table_fits(header->text_at, header->text_size, 1, pack.size)) return false;
+
+    uint64_t checksum = 14695981039346656037ULL;
+    checksum = hash_bytes(checksum, pack.chapters, header->chapter_count * sizeof(struct StoryPackChapter));
+    checksum = hash_bytes(checksum, pack.paragraphs, header->paragraph_count * sizeof(struct StoryPackParagraph));
+    checksum = hash_bytes(checksum, pack.perspectives, header->perspective_count * sizeof(uint32_t));
+    checksum = hash_bytes(checksum, pack.characters, header->character_count * sizeof(struct StoryPackCharacter));
+    if (checksum != header->tables_checksum) return false;
+
+    if (header->chapter_count == 0 || header->perspective_count == 0 || header->text_size == 0) return false;
+    if (pack.text[header->text_size - 1] != '\0') return false; // Every string ends inside the blob
+
+    for (uint32_t c = 0; c < header->chapter_count; c++) {
+        const struct StoryPackChapter *chapter = &pack.chapters[c];
+        if (chapter->title >= header->text_size || chapter->text_end > header->text_size || chapter->title > chapter->text_end ||
+            chapter->paragraph_count == 0 || chapter->first_paragraph > header->paragraph_count ||
+            chapter->paragraph_count > header->paragraph_count - chapter->first_paragraph) return false;
+    }
+    for (uint32_t p = 0; p < header->paragraph_count; p++) {
+        if (pack.paragraphs[p].text >= header->text_size || pack.paragraphs[p].perspective >= header->perspective_count) return false;
+    }
+    for (uint32_t v = 0; v < header->perspective_count; v++) {
+        if (pack.perspectives[v] >= header->text_size) return false;
+    }
+    for (uint32_t h = 0; h < header->character_count; h++) {
+        const struct StoryPackCharacter *character = &pack.characters[h];
+        if (character->name >= header->text_size || character->title >= header->text_size ||
+            character->description >= header->text_size) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Maps the story pack. The first chapter is read ahead; the rest is paged in when shown.
+ * @return false, with the reason on stderr, if the file is missing or damaged.
+ */
+bool story_pack_open(const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Could not open the story pack '%s'.\n", path);
+        return false;
+    }
+    struct stat info;
+    void *mapping = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(struct StoryPackHeader)) {
+        mapping = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        fprintf(stderr, "Error: Could not map the story pack '%s'.\n", path);
+        return false;
+    }
+
+    pack.base = mapping;
+    pack.size = (size_t)info.st_size;
+    pack.header = mapping;
+    pack.chapters = (const struct StoryPackChapter *)(pack.base + pack.header->chapters_at);
+    pack.paragraphs = (const struct StoryPackParagraph *)(pack.base + pack.header->paragraphs_at);
+    pack.perspectives = (const uint32_t *)(pack.base + pack.header->perspectives_at);
+    pack.characters = (const struct StoryPackCharacter *)(pack.base + pack.header->characters_at);
+    pack.text = pack.base + pack.header->text_at;
+    if (!pack_is_valid()) {
+        fprintf(stderr, "Error: The story pack '%s' is damaged or from another version. Pack it again.\n", path);
+        story_pack_close();
+        return false;
+    }
+    pack.sections = calloc(pack.header->chapter_count + 1, 1);
+    if (pack.sections == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for the story pack.\n");
+        story_pack_close();
+        return false;
+    }
+    story_prefetch_chapter(0);
+    return true;
+}
+
+void story_pack_close(void)
+{
+    if (pack.base != NULL) munmap((void *)pack.base, pack.size);
+    free(pack.sections);
+    memset(&pack, 0, sizeof(pack));
+}
+
+/**
+ * @brief Whether a stretch of text matches its checksum: chapter `section`, or the text after
+ * the chapters when `section` is the chapter count. Each is hashed the first time it is read.
+ */
+static bool section_is_intact(uint32_t section)
+{
+    pthread_mutex_lock(&sections_mutex);
+    if (pack.sections[section] == SECTION_UNCHECKED) {
+        uint32_t chapter_count = pack.header->chapter_count;
+        uint32_t begin, end;
+        uint64_t expected;
+        if (section < chapter_count) {
+            begin = pack.chapters[section].title;
+            end = pack.chapters[section].text_end;
+            expected = pack.chapters[section].checksum;
+        } else {
+            begin = pack.chapters[chapter_count - 1].text_end;
+            end = pack.header->text_size;
+            expected = pack.header->extras_checksum;
+        }
+        bool intact = hash_bytes(14695981039346656037ULL, pack.text + begin, end - begin) == expected;
+        pack.sections[section] = intact ? SECTION_INTACT : SECTION_DAMAGED;
+        if (!intact && section < chapter_count) {
+            fprintf(stderr, "Error: Chapter %u of the story pack is damaged. Pack the story again.\n", section + 1);
+        } else if (!intact) {
+            fprintf(stderr, "Error: The perspectives and bios of the story pack are damaged. Pack the story again.\n");
+        }
+    }
+    bool intact = pack.sections[section] == SECTION_INTACT;
+    pthread_mutex_unlock(&sections_mutex);
+    return intact;
+}
+
+/**
+ * @brief Asks the kernel to start reading a chapter's text, ahead of it being shown.
+ */
+void story_prefetch_chapter(int chapter)
+{
+    if (chapter < 0 || chapter >= story_chapter_count()) return;
+    long page_size = sysconf(_SC_PAGESIZE);
+    size_t start = pack.header->text_at + pack.chapters[chapter].title;
+    size_t end = pack.header->text_at + pack.chapters[chapter].text_end;
+    start -= start % (size_t)page_size; // madvise wants a page-aligned start
+    if (end > start) madvise((void *)(pack.base + start), end - start, MADV_WILLNEED);
+}
+
+int story_chapter_count(void)
+{
+    return pack.header != NULL ? (int)pack.header->chapter_count : 0;
+}
+
+const char *story_chapter_title(int chapter)
+{
+    if (!section_is_intact((uint32_t)chapter)) return DAMAGED_TEXT;
+    return pack.text + pack.chapters[chapter].title;
+}
+
+int story_paragraph_count(int chapter)
+{
+    return (int)pack.chapters[chapter].paragraph_count;
+}
+
+const char *story_paragraph(int chapter, int paragraph)
+{
+    if (!section_is_intact((uint32_t)chapter)) return DAMAGED_TEXT;
+    return pack.text + pack.paragraphs[pack.chapters[chapter].first_paragraph + paragraph].text;
+}
+
+/**
+ * @brief Who tells the paragraph; "Narrator" for the narrator.
+ */
+const char *story_perspective(int chapter, int paragraph)
+{
+    if (!section_is_intact(pack.header->chapter_count)) return DAMAGED_TEXT;
+    uint32_t perspective = pack.paragraphs[pack.chapters[chapter].first_paragraph + paragraph].perspective;
+    return pack.text + pack.perspectives[perspective];
+}
+
+int story_character_count(void)
+{
+    return pack.header != NULL ? (int)pack.header->character_count : 0;
+}
+
+const char *story_character_name(int character)
+{
+    if (!section_is_intact(pack.header->chapter_count)) return DAMAGED_TEXT;
+    return pack.text + pack.characters[character].name;
+}
+
+const char *story_character_title(int character)
+{
+    if (!section_is_intact(pack.header->chapter_count)) return DAMAGED_TEXT;
+    return pack.text + pack.characters[character].title;
+}
+
+const char *story_character_description(int character)
+{
+    if (!section_is_intact(pack.header->chapter_count)) return DAMAGED_TEXT;
+    return pack.text + pack.characters[character].description;
+}
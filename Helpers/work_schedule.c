@@ -0,0 +1,108 @@
+// file: work_schedule.c
+
+#include <time.h>
+#include "../work_schedule.h"
+#include "../game_config.h"
+
+#define THROUGHPUT_SMOOTHING 0.25 // Weight of the newest measurement in ns_per_human
+
+void work_schedule_init(struct WorkSchedule *schedule) {
+    schedule->day = -1;
+    schedule->cursor = 0;
+    schedule->ns_per_human = 0.0;
+    schedule->layout_generation = 0;
+    for (int k = 0; k < NUM_KINGDOMS; k++) schedule->shard_end[k] = 0;
+}
+
+/**
+ * @brief Remembers where every kingdom's citizens end now, so the next catch-up only looks past it.
+ */
+static void mark_layout(struct WorkSchedule *schedule, const struct Human_Data *data) {
+    schedule->layout_generation = data->layout_generation;
+    for (int k = 0; k < NUM_KINGDOMS; k++) {
+        schedule->shard_end[k] = data->is_sharded ? data->shard_start[k] + data->shard_size[k] : 0;
+    }
+}
+
+void work_schedule_next_slice(struct WorkSchedule *schedule, const struct Human_Data *data,
+                              int day, int hour, int *begin, int *end) {
+    *begin = 0;
+    *end = 0;
+    if (hour < WORK_START_HOUR || hour >= WORK_END_HOUR) return;
+
+    if (schedule->day != day) {
+        schedule->day = day;
+        schedule->cursor = 0;
+        mark_layout(schedule, data);
+    }
+    if (schedule->cursor > data->count) schedule->cursor = data->count;
+
+    clock_gettime(CLOCK_MONOTONIC, &schedule->slice_started);
+
+    // In the last work hour the even pace hands out everything left
+    int hours_left = WORK_END_HOUR - hour;
+    int remaining = data->count - schedule->cursor;
+    int slice = (remaining + hours_left - 1) / hours_left; // Even pace that finishes the day on time
+    if (schedule->ns_per_human > 0.0) {
+        double budget_slice = (WORK_TICK_BUDGET_MS * 1000000.0) / schedule->ns_per_human;
+        if (budget_slice > slice) slice = budget_slice < remaining ? (int)budget_slice : remaining;
+    }
+
+    *begin = schedule->cursor;
+    *end = schedule->cursor + slice;
+    schedule->cursor = *end;
+}
+
+void work_schedule_resize_slice(struct WorkSchedule *schedule, const struct Human_Data *data,
+                                int slice_size, int begin, int *end) {
+    *end = begin + slice_size;
+    if (*end > data->count) *end = data->count;
+    if (*end < begin) *end = begin;
+    schedule->cursor = *end;
+}
+
+int work_schedule_catch_up(struct WorkSchedule *schedule, const struct Human_Data *data, int hour,
+                           int begin[NUM_KINGDOMS], int end[NUM_KINGDOMS]) {
+    if (hour < WORK_START_HOUR || hour >= WORK_END_HOUR || schedule->day < 0) return 0;
+
+    int ranges = 0;
+    int behind = schedule->cursor < data->count ? schedule->cursor : data->count;
+    if (schedule->layout_generation != data->layout_generation) {
+        // Regrouped: anyone may have moved behind the cursor
+        if (behind > 0) {
+            begin[0] = 0;
+            end[0] = behind;
+            ranges = 1;
+        }
+    } else if (data->is_sharded) {
+        // Newborns fill each shard from its old end
+        for (int k = 0; k < NUM_KINGDOMS; k++) {
+            int from = schedule->shard_end[k];
+            int to = data->shard_start[k] + data->shard_size[k];
+            if (to > behind) to = behind;
+            if (from < to) {
+                begin[ranges] = from;
+                end[ranges] = to;
+                ranges++;
+            }
+        }
+    }
+    mark_layout(schedule, data);
+    return ranges;
+}
+
+void work_schedule_finish_slice(struct WorkSchedule *schedule, int slice_size) {
+    if (slice_size <= 0) return;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double elapsed_ns = (now.tv_sec - schedule->slice_started.tv_sec) * 1e9 +
+                        (now.tv_nsec - schedule->slice_started.tv_nsec);
+    double measured = elapsed_ns / slice_size;
+
+    if (schedule->ns_per_human <= 0.0) {
+        schedule->ns_per_human = measured;
+    } else {
+        schedule->ns_per_human += THROUGHPUT_SMOOTHING * (measured - schedule->ns_per_human);
+    }
+}
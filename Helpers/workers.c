@@ -0,0 +1,215 @@
+// file: workers.c
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#include "../workers.h"
+
+static pthread_t worker_threads[MAX_WORKER_THREADS];
+static int worker_total = 0;
+
+// NUMA mode: every worker is pinned to one core, cores taken node by node
+static bool numa_mode = false;
+static int worker_cpu[MAX_WORKER_THREADS];
+static int worker_node[MAX_WORKER_THREADS];
+
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t work_ready = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t work_done = PTHREAD_COND_INITIALIZER;
+
+// The run currently handed out to the workers
+static void (*current_task)(int, void *) = NULL;
+static void *current_context = NULL;
+static int current_task_count = 0;
+static int run_generation = 0;
+static int workers_finished = 0;
+static bool shutting_down = false;
+
+#ifdef __linux__
+#define MAX_NUMA_NODES 64
+#define MAX_NUMA_CPUS 1024
+
+/**
+ * @brief Reads a kernel cpulist such as "0-15,32-47" into `cpus`.
+ * @return The number of CPUs read.
+ */
+static int parse_cpu_list(const char *text, int cpus[], int max_cpus) {
+    int count = 0;
+    while (*text != '\0' && *text != '\n') {
+        int first, last, used;
+        if (sscanf(text, "%d%n", &first, &used) != 1) break;
+        text += used;
+        last = first;
+        if (*text == '-') {
+            text++;
+            if (sscanf(text, "%d%n", &last, &used) != 1) break;
+            text += used;
+        }
+        for (int cpu = first; cpu <= last && count < max_cpus; cpu++) cpus[count++] = cpu;
+        if (*text == ',') text++;
+    }
+    return count;
+}
+
+/**
+ * @brief Gives every worker a core, filling one NUMA node before moving to the next, so
+ * neighbouring workers share a node. Falls back to no pinning if the topology can't be read.
+ */
+static bool plan_worker_placement(int worker_count) {
+    static int cpus[MAX_NUMA_CPUS];
+    static int cpu_nodes[MAX_NUMA_CPUS];
+    int cpu_count = 0;
+    for (int node = 0; node < MAX_NUMA_NODES && cpu_count < MAX_NUMA_CPUS; node++) {
+        char path[64], list[4096];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        FILE *file = fopen(path, "r");
+        if (file == NULL) continue;
+        bool read = fgets(list, sizeof(list), file) != NULL;
+        fclose(file);
+        if (!read) continue;
+        int added = parse_cpu_list(list, &cpus[cpu_count], MAX_NUMA_CPUS - cpu_count);
+        for (int c = cpu_count; c < cpu_count + added; c++) cpu_nodes[c] = node;
+        cpu_count += added;
+    }
+    if (cpu_count == 0) return false;
+
+    for (int w = 0; w < worker_count; w++) {
+        worker_cpu[w] = cpus[w % cpu_count];
+        worker_node[w] = cpu_nodes[w % cpu_count];
+    }
+    return true;
+}
+
+static void pin_worker(pthread_t thread, int worker_index) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(worker_cpu[worker_index], &set);
+    if (pthread_setaffinity_np(thread, sizeof(set), &set) != 0) {
+        fprintf(stderr, "Warning: Could not pin simulation worker %d to CPU %d.\n", worker_index, worker_cpu[worker_index]);
+    }
+}
+#endif
+
+static void *worker_main(void *arg) {
+    int worker_index = (int)(long)arg;
+    int seen_generation = 0;
+
+    pthread_mutex_lock(&pool_mutex);
+    while (true) {
+        while (run_generation == seen_generation && !shutting_down) {
+            pthread_cond_wait(&work_ready, &pool_mutex);
+        }
+        if (shutting_down) break;
+
+        seen_generation = run_generation;
+        void (*task)(int, void *) = current_task;
+        void *context = current_context;
+        int task_count = current_task_count;
+        pthread_mutex_unlock(&pool_mutex);
+
+        for (int t = worker_index; t < task_count; t += worker_total) {
+            task(t, context);
+        }
+
+        pthread_mutex_lock(&pool_mutex);
+        workers_finished++;
+        if (workers_finished == worker_total) pthread_cond_signal(&work_done);
+    }
+    pthread_mutex_unlock(&pool_mutex);
+    return NULL;
+}
+
+void workers_set_numa(bool enabled) {
+    if (worker_total == 0) numa_mode = enabled;
+}
+
+bool workers_numa(void) {
+    return numa_mode && worker_total > 1;
+}
+
+void workers_start(int worker_count) {
+    if (worker_total > 0) return; // Already running
+
+    if (worker_count <= 0) worker_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (worker_count < 1) worker_count = 1;
+    if (worker_count > MAX_WORKER_THREADS) worker_count = MAX_WORKER_THREADS;
+
+    // A single worker would only add a hand-off; workers_run does the work inline instead.
+    if (worker_count == 1) return;
+
+#ifdef __linux__
+    if (numa_mode && !plan_worker_placement(worker_count)) {
+        fprintf(stderr, "Warning: Could not read the NUMA topology; simulation workers are not pinned.\n");
+        numa_mode = false;
+    }
+#else
+    numa_mode = false;
+#endif
+
+    shutting_down = false;
+    worker_total = worker_count;
+    for (int i = 0; i < worker_count; i++) {
+        if (pthread_create(&worker_threads[i], NULL, worker_main, (void *)(long)i) != 0) {
+            fprintf(stderr, "Warning: Could only start %d simulation workers.\n", i);
+            worker_total = i;
+            break;
+        }
+#ifdef __linux__
+        if (numa_mode) pin_worker(worker_threads[i], i);
+#endif
+    }
+
+    if (numa_mode) {
+        int nodes = 0;
+        for (int i = 0; i < worker_total; i++) {
+            bool seen = false;
+            for (int j = 0; j < i; j++) seen = seen || worker_node[j] == worker_node[i];
+            if (!seen) nodes++;
+        }
+        printf("Simulation workers pinned: %d workers over %d NUMA node(s).\n", worker_total, nodes);
+    }
+}
+
+void workers_stop(void) {
+    if (worker_total == 0) return;
+
+    pthread_mutex_lock(&pool_mutex);
+    shutting_down = true;
+    pthread_cond_broadcast(&work_ready);
+    pthread_mutex_unlock(&pool_mutex);
+
+    for (int i = 0; i < worker_total; i++) {
+        pthread_join(worker_threads[i], NULL);
+    }
+    worker_total = 0;
+}
+
+int workers_count(void) {
+    return (worker_total > 0) ? worker_total : 1;
+}
+
+void workers_run(int task_count, void (*task)(int task_index, void *context), void *context) {
+    if (task_count <= 0) return;
+
+    if (worker_total <= 1) {
+        for (int t = 0; t < task_count; t++) task(t, context);
+        return;
+    }
+
+    pthread_mutex_lock(&pool_mutex);
+    current_task = task;
+    current_context = context;
+    current_task_count = task_count;
+    workers_finished = 0;
+    run_generation++;
+    pthread_cond_broadcast(&work_ready);
+    while (workers_finished < worker_total) {
+        pthread_cond_wait(&work_done, &pool_mutex);
+    }
+    pthread_mutex_unlock(&pool_mutex);
+}
@@ -0,0 +1,641 @@
+// file: cohorts.c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../cohorts.h"
+#include "../game_config.h"
+#include "../rng.h"
+#include "../lifecycle.h"
+
+struct CohortPopulation g_cohorts;
+
+#define COHORT_EXACT_DRAWS 32   // Below this many trials, draw every one of them
+#define COHORT_CELLS_PER_JOB (COHORT_HEALTH_BUCKETS * COHORT_HUNGER_BUCKETS)
+#define COHORT_MAX_GATHERED (NUM_KINGDOMS * (JOB_REBEL + 1) * COHORT_CELLS_PER_JOB)
+
+// Scratch lists for the splitting helpers. Only the simulation thread uses them.
+static struct Cohort *gathered[COHORT_MAX_GATHERED];
+static int gathered_sizes[COHORT_MAX_GATHERED];
+static int gathered_split[COHORT_MAX_GATHERED];
+
+// --- Sampling ---
+
+static double uniform01(void)
+{
+    return ((double)rng_next(&g_sim_rng) + 0.5) / 4294967296.0;
+}
+
+static double standard_normal(void)
+{
+    double u1 = uniform01();
+    double u2 = uniform01();
+    return sqrt(-2.0 * log(u1)) * cos(6.283185307179586 * u2);
+}
+
+/**
+ * @brief Number of successes in n trials of probability p.
+ * Small groups are drawn trial by trial, rare events by skipping ahead between successes,
+ * and everything else from the normal approximation.
+ */
+int cohort_binomial(int n, double p)
+{
+    if (n <= 0 || p <= 0.0) return 0;
+    if (p >= 1.0) return n;
+    if (p > 0.5) return n - cohort_binomial(n, 1.0 - p);
+
+    if (n <= COHORT_EXACT_DRAWS) {
+        int successes = 0;
+        for (int i = 0; i < n; i++) {
+            if (uniform01() < p) successes++;
+        }
+        return successes;
+    }
+
+    double mean = n * p;
+    if (mean < 30.0) {
+        // The gaps between successes are geometric
+        double log_miss = log1p(-p);
+        int successes = 0;
+        long long position = 0;
+        while (1) {
+            position += (long long)(log(uniform01()) / log_miss) + 1;
+            if (position > n) break;
+            successes++;
+        }
+        return successes;
+    }
+
+    double k = mean + sqrt(mean * (1.0 - p)) * standard_normal() + 0.5;
+    if (k < 0.0) return 0;
+    if (k > n) return n;
+    return (int)k;
+}
+
+/**
+ * @brief Sum of n rolls of min + rand() % range, as the individual model would draw them.
+ */
+long long cohort_sum_uniform(int n, int min, int range)
+{
+    if (n <= 0) return 0;
+    if (range <= 1) return (long long)n * min;
+
+    if (n <= COHORT_EXACT_DRAWS) {
+        long long sum = 0;
+        for (int i = 0; i < n; i++) sum += min + (int)(rng_next(&g_sim_rng) % (uint32_t)range);
+        return sum;
+    }
+
+    double mean = n * (min + (range - 1) / 2.0);
+    double variance = n * ((double)range * range - 1.0) / 12.0;
+    double sum = mean + sqrt(variance) * standard_normal() + 0.5;
+    double lowest = (double)n * min;
+    double highest = (double)n * (min + range - 1);
+    if (sum < lowest) sum = lowest;
+    if (sum > highest) sum = highest;
+    return (long long)sum;
+}
+
+/**
+ * @brief Splits `total` draws over groups of the given sizes, as if the members had been picked
+ * one by one from all groups together. No group gives more members than it has.
+ */
+static void split_over_groups(const int sizes[], int group_count, int total, int out[])
+{
+    long long pool = 0;
+    for (int i = 0; i < group_count; i++) pool += sizes[i];
+    if (total > pool) total = (int)pool;
+
+    for (int i = 0; i < group_count; i++) {
+        out[i] = 0;
+        if (sizes[i] <= 0) continue;
+        long long rest = pool - sizes[i];
+        if (total > 0) {
+            int n = (rest == 0) ? total : cohort_binomial(total, (double)sizes[i] / (double)pool);
+            if (n < total - rest) n = (int)(total - rest); // The others can't take the remainder
+            if (n > sizes[i]) n = sizes[i];
+            out[i] = n;
+            total -= n;
+        }
+        pool = rest;
+    }
+}
+
+/**
+ * @brief Lists the cells of the given kingdoms, jobs and hunger buckets in a fixed order
+ * ([kingdom][job][health][hunger]) and returns how many there are.
+ */
+static int gather_cells(int first_kingdom, int last_kingdom, int first_job, int last_job, int first_hunger, int last_hunger)
+{
+    int n = 0;
+    for (int k = first_kingdom; k <= last_kingdom; k++)
+        for (int j = first_job; j <= last_job; j++)
+            for (int h = 0; h < COHORT_HEALTH_BUCKETS; h++)
+                for (int g = first_hunger; g <= last_hunger; g++) {
+                    gathered[n] = &g_cohorts.cells[k][j][h][g];
+                    gathered_sizes[n] = gathered[n]->count;
+                    n++;
+                }
+    return n;
+}
+
+/**
+ * @brief Removes `total` members picked at random from the gathered cells.
+ */
+static int remove_from_gathered(int cell_count, int total)
+{
+    split_over_groups(gathered_sizes, cell_count, total, gathered_split);
+    int removed = 0;
+    for (int i = 0; i < cell_count; i++) {
+        if (gathered_split[i] == 0) continue;
+        cohort_take(gathered[i], gathered_split[i]);
+        removed += gathered_split[i];
+    }
+    return removed;
+}
+
+// --- Bookkeeping ---
+
+int cohort_health_bucket(int health)
+{
+    int bucket = health / COHORT_HEALTH_BUCKET_WIDTH;
+    if (bucket < 0) return 0;
+    if (bucket >= COHORT_HEALTH_BUCKETS) return COHORT_HEALTH_BUCKETS - 1;
+    return bucket;
+}
+
+int cohort_hunger_bucket(int hunger)
+{
+    int bucket = hunger / COHORT_HUNGER_BUCKET_WIDTH;
+    if (bucket < 0) return 0;
+    if (bucket >= COHORT_HUNGER_BUCKETS) return COHORT_HUNGER_BUCKETS - 1;
+    return bucket;
+}
+
+/**
+ * @brief Takes n members out of a cohort, together with their share of its totals.
+ */
+struct Cohort cohort_take(struct Cohort *from, int n)
+{
+    struct Cohort group = {0};
+    if (n <= 0 || from->count <= 0) return group;
+    if (n >= from->count) {
+        group = *from;
+        memset(from, 0, sizeof(*from));
+        return group;
+    }
+
+    double share = (double)n / (double)from->count;
+    group.count = n;
+    group.bronze = (long long)(from->bronze * share);
+    group.damage = (long long)(from->damage * share);
+    group.defense = (long long)(from->defense * share);
+
+    from->count -= n;
+    from->bronze -= group.bronze;
+    from->damage -= group.damage;
+    from->defense -= group.defense;
+    return group;
+}
+
+void cohort_merge(struct Cohort *into, const struct Cohort *group)
+{
+    into->count += group->count;
+    into->bronze += group->bronze;
+    into->damage += group->damage;
+    into->defense += group->defense;
+}
+
+/**
+ * @brief Moves members whose hunger changed by `change` into their new hunger buckets.
+ * Members are spread uniformly over a bucket, so change / width of them cross into the next one.
+ */
+static void place_by_hunger(CohortKingdom into, int job, int health_bucket, int hunger_bucket,
+                            struct Cohort group, int change)
+{
+    if (group.count == 0) return;
+    int whole = change / COHORT_HUNGER_BUCKET_WIDTH;
+    int part = abs(change % COHORT_HUNGER_BUCKET_WIDTH);
+    int step = (change < 0) ? -1 : 1;
+
+    struct Cohort crossing = cohort_take(&group, cohort_binomial(group.count, (double)part / COHORT_HUNGER_BUCKET_WIDTH));
+    int stay = cohort_hunger_bucket((hunger_bucket + whole) * COHORT_HUNGER_BUCKET_WIDTH);
+    int cross = cohort_hunger_bucket((hunger_bucket + whole + step) * COHORT_HUNGER_BUCKET_WIDTH);
+
+    cohort_merge(&into[job][health_bucket][stay], &group);
+    cohort_merge(&into[job][health_bucket][cross], &crossing);
+}
+
+/**
+ * @brief Puts a group back into `into` after its members' health and hunger changed.
+ * Those pushed below the lowest health bucket die.
+ * @return The number of members who died.
+ */
+int cohort_place(CohortKingdom into, int job, int health_bucket, int hunger_bucket,
+                 struct Cohort group, int health_change, int hunger_change)
+{
+    if (group.count == 0) return 0;
+    int whole = health_change / COHORT_HEALTH_BUCKET_WIDTH;
+    int part = abs(health_change % COHORT_HEALTH_BUCKET_WIDTH);
+    int step = (health_change < 0) ? -1 : 1;
+
+    struct Cohort crossing = cohort_take(&group, cohort_binomial(group.count, (double)part / COHORT_HEALTH_BUCKET_WIDTH));
+    int died = 0;
+    struct Cohort *groups[2] = { &group, &crossing };
+    int buckets[2] = { health_bucket + whole, health_bucket + whole + step };
+
+    for (int i = 0; i < 2; i++) {
+        if (groups[i]->count == 0) continue;
+        if (buckets[i] < 0) {
+            died += groups[i]->count;
+            continue;
+        }
+        int bucket = (buckets[i] >= COHORT_HEALTH_BUCKETS) ? COHORT_HEALTH_BUCKETS - 1 : buckets[i];
+        place_by_hunger(into, job, bucket, hunger_bucket, *groups[i], hunger_change);
+    }
+    return died;
+}
+
+int cohort_job_count(int kingdom_id, int job)
+{
+    int count = 0;
+    for (int h = 0; h < COHORT_HEALTH_BUCKETS; h++)
+        for (int g = 0; g < COHORT_HUNGER_BUCKETS; g++)
+            count += g_cohorts.cells[kingdom_id][job][h][g].count;
+    return count;
+}
+
+int cohort_population(int kingdom_id)
+{
+    int population = 0;
+    for (int j = 0; j <= JOB_REBEL; j++) population += cohort_job_count(kingdom_id, j);
+    return population;
+}
+
+// --- Population changes ---
+
+/**
+ * @brief Adds `count` new members with the given stats. Damage and defense are rolled as
+ * attribute_min + rand() % attribute_range, like a newborn's.
+ */
+static void add_group(int kingdom_id, int job, int count, int health, int hunger,
+                      int attribute_min, int attribute_range)
+{
+    if (count <= 0) return;
+    struct Cohort group = {
+        .count = count,
+        .bronze = (long long)count * STARTING_BRONZE,
+        .damage = cohort_sum_uniform(count, attribute_min, attribute_range),
+        .defense = cohort_sum_uniform(count, attribute_min, attribute_range),
+    };
+    cohort_merge(&g_cohorts.cells[kingdom_id][job][cohort_health_bucket(health)][cohort_hunger_bucket(hunger)], &group);
+}
+
+/**
+ * @brief Switches the simulation to cohorts and creates the Empire's starting population.
+ * The job split is the one initial_job_assignment ends up with: 5% each of archers, cavalry
+ * and swordsmen, everyone else on the farms. The first generals step out of the ranks as notables.
+ */
+void cohorts_init(int population, struct Human_Data *data)
+{
+    memset(&g_cohorts, 0, sizeof(g_cohorts));
+    g_cohorts.enabled = true;
+
+    int archers = cohort_binomial(population, 0.05);
+    int cavalry = cohort_binomial(population - archers, 0.05 / 0.95);
+    int swordsmen = cohort_binomial(population - archers - cavalry, 0.05 / 0.90);
+    int farmers = population - archers - cavalry - swordsmen;
+
+    int generals = cohort_binomial(swordsmen, GENERAL_SPAWN_CHANCE_PERCENT / 100.0);
+    if (generals > INITIAL_GENERAL_LIMIT) generals = INITIAL_GENERAL_LIMIT;
+
+    add_group(0, JOB_ARCHER, archers, 200, 100, 1, 30);
+    add_group(0, JOB_CAVALRY, cavalry, 200, 100, 1, 30);
+    add_group(0, JOB_SWORDSMAN, swordsmen, 200, 100, 1, 30);
+    add_group(0, JOB_FARMER, farmers, 200, 100, 1, 30);
+    generals = cohort_promote(data, 0, JOB_SWORDSMAN, generals);
+
+    printf("Cohort population created: %d citizens, %d generals.\n", population, generals);
+}
+
+/**
+ * @brief Adds members who arrive with a job, like the divine recruits.
+ */
+void cohort_add_members(int kingdom_id, int job, int count, int health, int hunger)
+{
+    add_group(kingdom_id, job, count, health, hunger, 0, 10);
+}
+
+/**
+ * @brief Newborns of a kingdom, each hired straight away by the labor market.
+ */
+static void add_newborns(struct Kingdom kingdoms[], int kingdom_id, int count)
+{
+    int hires[JOB_BLACKSMITH + 1] = {0};
+    for (int i = 0; i < count; i++) hires[choose_job_for_hire(&kingdoms[kingdom_id])]++;
+    for (int j = JOB_FARMER; j <= JOB_BLACKSMITH; j++) {
+        add_group(kingdom_id, j, hires[j], 200, 100, 0, 10);
+    }
+}
+
+/**
+ * @brief The cohort counterpart of persona: every kingdom's newborns join its own cohorts.
+ */
+void cohort_births(struct Kingdom kingdoms[], const int births[NUM_KINGDOMS])
+{
+    for (int k = 0; k < NUM_KINGDOMS; k++) {
+        if (births[k] > 0) add_newborns(kingdoms, k, births[k]);
+    }
+}
+
+/**
+ * @brief Old age and illness: `count` members die, picked from the whole world.
+ */
+void cohort_natural_deaths(int count)
+{
+    int cells = gather_cells(0, NUM_KINGDOMS - 1, 0, JOB_REBEL, 0, COHORT_HUNGER_BUCKETS - 1);
+    remove_from_gathered(cells, count);
+}
+
+/**
+ * @brief Kills up to `count` members of a kingdom with a job in [first_job, last_job].
+ * With hungriest_first the emptiest stomachs go first, like starve_population.
+ * @return The number of people who died.
+ */
+int cohort_kill(int kingdom_id, int first_job, int last_job, int count, bool hungriest_first)
+{
+    if (count <= 0) return 0;
+    if (!hungriest_first) {
+        int cells = gather_cells(kingdom_id, kingdom_id, first_job, last_job, 0, COHORT_HUNGER_BUCKETS - 1);
+        return remove_from_gathered(cells, count);
+    }
+
+    int killed = 0;
+    for (int g = 0; g < COHORT_HUNGER_BUCKETS && killed < count; g++) {
+        int cells = gather_cells(kingdom_id, kingdom_id, first_job, last_job, g, g);
+        killed += remove_from_gathered(cells, count - killed);
+    }
+    return killed;
+}
+
+/**
+ * @brief Gives `count` random members of `from_job` the job `to_job`. They keep their health,
+ * hunger and purse. @return How many changed jobs.
+ */
+int cohort_move_jobs(int kingdom_id, int from_job, int to_job, int count)
+{
+    if (count <= 0 || from_job == to_job) return 0;
+    int cells = gather_cells(kingdom_id, kingdom_id, from_job, from_job, 0, COHORT_HUNGER_BUCKETS - 1);
+    split_over_groups(gathered_sizes, cells, count, gathered_split);
+
+    int moved = 0;
+    for (int i = 0; i < cells; i++) {
+        if (gathered_split[i] == 0) continue;
+        int h = i / COHORT_HUNGER_BUCKETS;
+        int g = i % COHORT_HUNGER_BUCKETS;
+        struct Cohort group = cohort_take(gathered[i], gathered_split[i]);
+        cohort_merge(&g_cohorts.cells[kingdom_id][to_job][h][g], &group);
+        moved += group.count;
+    }
+    return moved;
+}
+
+/**
+ * @brief Picks the civilian job of a random working citizen, or -1 if there are none.
+ */
+int cohort_pick_civilian_job(int kingdom_id)
+{
+    int counts[JOB_BLACKSMITH + 1] = {0};
+    long long civilians = 0;
+    for (int j = JOB_FARMER; j <= JOB_BLACKSMITH; j++) {
+        counts[j] = cohort_job_count(kingdom_id, j);
+        civilians += counts[j];
+    }
+    if (civilians == 0) return -1;
+
+    long long pick = (long long)(uniform01() * civilians);
+    for (int j = JOB_FARMER; j <= JOB_BLACKSMITH; j++) {
+        if (pick < counts[j]) return j;
+        pick -= counts[j];
+    }
+    return JOB_BLACKSMITH;
+}
+
+void cohort_add_bronze(int kingdom_id, int amount_each)
+{
+    int cells = gather_cells(kingdom_id, kingdom_id, 0, JOB_REBEL, 0, COHORT_HUNGER_BUCKETS - 1);
+    for (int i = 0; i < cells; i++) gathered[i]->bronze += (long long)gathered[i]->count * amount_each;
+}
+
+/**
+ * @brief The Empire's cohorts scatter over the seven successor kingdoms, like
+ * join_successor_kingdom does for individuals. Soldiers and rebels become farmers.
+ */
+void cohort_collapse_empire(void)
+{
+    for (int j = 0; j <= JOB_REBEL; j++)
+        for (int h = 0; h < COHORT_HEALTH_BUCKETS; h++)
+            for (int g = 0; g < COHORT_HUNGER_BUCKETS; g++) {
+                struct Cohort *cell = &g_cohorts.cells[0][j][h][g];
+                int job = (j >= JOB_SWORDSMAN) ? JOB_FARMER : j;
+                for (int k = 1; k < NUM_KINGDOMS && cell->count > 0; k++) {
+                    int share = (k == NUM_KINGDOMS - 1) ? cell->count : cohort_binomial(cell->count, 1.0 / (NUM_KINGDOMS - k));
+                    struct Cohort group = cohort_take(cell, share);
+                    cohort_merge(&g_cohorts.cells[k][job][h][g], &group);
+                }
+            }
+}
+
+// --- Daily stages ---
+
+/**
+ * @brief The cohort side of the daily council: taxes, dissent and the census.
+ * Shares the per-kingdom rebel cap with the individual pass that ran before it. Rebels who
+ * turn out to be leaders are counted in new_leaders and promoted once the council is over.
+ */
+void cohort_daily_pass(struct KingdomDay days[], const bool managed[])
+{
+    for (int k = 0; k < NUM_KINGDOMS; k++) {
+        if (!managed[k]) continue;
+        struct KingdomDay *day = &days[k];
+        CohortKingdom *cells = &g_cohorts.cells[k];
+
+        // Taxes: a cohort pays when its average member can
+        for (int j = 0; j <= JOB_REBEL; j++)
+            for (int h = 0; h < COHORT_HEALTH_BUCKETS; h++)
+                for (int g = 0; g < COHORT_HUNGER_BUCKETS; g++) {
+                    struct Cohort *cell = &(*cells)[j][h][g];
+                    long long tax = (long long)cell->count * TAX_RATE_PER_PERSON;
+                    if (cell->count == 0 || cell->bronze < tax) continue;
+                    cell->bronze -= tax;
+                    day->taxes_collected += (int)tax;
+                }
+
+        // Dissent: draw the would-be rebels of every cohort, then hold them to today's cap
+        if (day->dissent_active && day->new_rebels < MAX_NEW_REBELS_PER_DAY) {
+            int cell_count = gather_cells(k, k, 0, JOB_CAVALRY, 0, COHORT_HUNGER_BUCKETS - 1);
+            for (int i = 0; i < cell_count; i++) {
+                bool is_soldier = (i >= JOB_SWORDSMAN * COHORT_CELLS_PER_JOB);
+                int chance = is_soldier ? day->soldier_defection_chance : day->civilian_rebel_chance;
+                gathered_sizes[i] = cohort_binomial(gathered[i]->count, (double)chance / REBEL_CHANCE_DIVISOR);
+            }
+            split_over_groups(gathered_sizes, cell_count, MAX_NEW_REBELS_PER_DAY - day->new_rebels, gathered_split);
+
+            for (int i = 0; i < cell_count; i++) {
+                if (gathered_split[i] == 0) continue;
+                int h = (i / COHORT_HUNGER_BUCKETS) % COHORT_HEALTH_BUCKETS;
+                int g = i % COHORT_HUNGER_BUCKETS;
+                struct Cohort rebels = cohort_take(gathered[i], gathered_split[i]);
+                if (i >= JOB_SWORDSMAN * COHORT_CELLS_PER_JOB) day->defections += rebels.count;
+                day->new_rebels += rebels.count;
+                day->new_leaders += cohort_binomial(rebels.count, REBEL_LEADER_SPAWN_CHANCE_PERCENT / 100.0);
+                cohort_merge(&(*cells)[JOB_REBEL][h][g], &rebels);
+            }
+        }
+
+        // Census
+        for (int j = 0; j <= JOB_REBEL; j++) {
+            int count = cohort_job_count(k, j);
+            day->population += count;
+            if (j >= JOB_SWORDSMAN && j <= JOB_CAVALRY) day->soldier_count += count;
+            else if (j == JOB_REBEL) day->rebel_count += count;
+            else day->job_census[j] += count;
+        }
+    }
+}
+
+/**
+ * @brief Totals of one job's cohorts, for the battle code. Health is taken at the middle of each bucket.
+ */
+void cohort_battle_stats(int kingdom_id, int job, int *count, long long *health, long long *damage, long long *defense)
+{
+    *count = 0;
+    *health = *damage = *defense = 0;
+    for (int h = 0; h < COHORT_HEALTH_BUCKETS; h++)
+        for (int g = 0; g < COHORT_HUNGER_BUCKETS; g++) {
+            const struct Cohort *cell = &g_cohorts.cells[kingdom_id][job][h][g];
+            *count += cell->count;
+            *health += (long long)cell->count * (h * COHORT_HEALTH_BUCKET_WIDTH + COHORT_HEALTH_BUCKET_WIDTH / 2);
+            *damage += cell->damage;
+            *defense += cell->defense;
+        }
+}
+
+// --- Notables ---
+// Generals and rebel leaders change the outcome of battles one by one, so they are simulated
+// as full Human_Stats in humans[]. Everyone else lives in the cohorts.
+
+bool cohort_is_notable(const struct Human_Stats *human)
+{
+    return human->is_general == 1 && human->job >= JOB_SWORDSMAN && human->job <= JOB_REBEL;
+}
+
+/**
+ * @brief Promotes `count` random members of a kingdom's `job` cohorts to notables. Each steps
+ * out of its cohort as a full Human_Stats with the cohort's average purse and attributes.
+ * @return The number promoted.
+ */
+int cohort_promote(struct Human_Data *data, int kingdom_id, int job, int count)
+{
+    if (count <= 0) return 0;
+    int cells = gather_cells(kingdom_id, kingdom_id, job, job, 0, COHORT_HUNGER_BUCKETS - 1);
+    split_over_groups(gathered_sizes, cells, count, gathered_split);
+
+    int total = 0;
+    for (int i = 0; i < cells; i++) total += gathered_split[i];
+    if (total == 0) return 0;
+
+    int start_index = reserve_kingdom_slots(data, kingdom_id, total);
+    if (start_index < 0) {
+        fprintf(stderr, "Error: Failed to reallocate memory for promoted notables.\n");
+        return 0;
+    }
+
+    int promoted = 0;
+    for (int i = 0; i < cells; i++) {
+        if (gathered_split[i] == 0) continue;
+        int h = i / COHORT_HUNGER_BUCKETS;
+        int g = i % COHORT_HUNGER_BUCKETS;
+        struct Cohort group = cohort_take(gathered[i], gathered_split[i]);
+
+        for (int m = 0; m < group.count; m++) {
+            struct Human_Stats *human = &data->humans[start_index + promoted++];
+            memset(human, 0, sizeof(*human));
+            human->health = h * COHORT_HEALTH_BUCKET_WIDTH + COHORT_HEALTH_BUCKET_WIDTH / 2;
+            human->hunger = g * COHORT_HUNGER_BUCKET_WIDTH + COHORT_HUNGER_BUCKET_WIDTH / 2;
+            human->bronze = (int)(group.bronze / group.count);
+            human->damage = (int)(group.damage / group.count);
+            human->defense = (int)(group.defense / group.count);
+            human->job = job;
+            human->kingdom_id = kingdom_id;
+            human->is_general = 1;
+            human->alive = 1;
+        }
+    }
+    lifecycle_start(data, start_index, promoted, false);
+    for (int i = start_index; i < start_index + promoted; i++) {
+        struct Human_Details *details = human_details(data, i);
+        if (details != NULL) details->name = (job == JOB_REBEL) ? "Rebel Leader" : "General";
+    }
+    return promoted;
+}
+
+/**
+ * @brief Folds every living individual who is no longer notable back into their kingdom's
+ * cohorts: generals who left the army, leaders who left the rebels. Their records are
+ * marked dead, so the nightly compaction clears them.
+ * @return The number demoted.
+ */
+int cohort_demote_ordinary(struct Human_Data *data)
+{
+    int demoted = 0;
+    for (int i = 0; i < data->count; i++) {
+        struct Human_Stats *human = &data->humans[i];
+        if (human->alive != 1 || cohort_is_notable(human)) continue;
+        int k = human->kingdom_id;
+        if (k < 0 || k >= NUM_KINGDOMS || human->job < 0 || human->job > JOB_REBEL) continue;
+
+        int job = (human->job == 0) ? JOB_FARMER : human->job;
+        struct Cohort member = { 1, human->bronze, human->damage, human->defense };
+        cohort_merge(&g_cohorts.cells[k][job][cohort_health_bucket(human->health)][cohort_hunger_bucket(human->hunger)], &member);
+        lifecycle_remove(human);
+        human->alive = 0;
+        demoted++;
+    }
+    return demoted;
+}
+
+/**
+ * @brief How many of `count` deaths among a kingdom's jobs [first_job, last_job] fall on its
+ * notables (kingdom_id -1: the whole world). Every death is as likely to hit a notable as
+ * anyone in the cohorts.
+ */
+int cohort_notable_quota(const struct Human_Data *data, int kingdom_id, int first_job, int last_job, int count)
+{
+    if (count <= 0) return 0;
+
+    int notables = 0;
+    int begin = 0, end = data->count;
+    if (kingdom_id >= 0) kingdom_range(data, kingdom_id, &begin, &end);
+    for (int i = begin; i < end; i++) {
+        const struct Human_Stats *human = &data->humans[i];
+        if (human->alive == 1 && (kingdom_id < 0 || human->kingdom_id == kingdom_id) &&
+            human->job >= first_job && human->job <= last_job) {
+            notables++;
+        }
+    }
+    if (notables == 0) return 0;
+
+    long long members = 0;
+    for (int k = 0; k < NUM_KINGDOMS; k++) {
+        if (kingdom_id >= 0 && k != kingdom_id) continue;
+        for (int j = first_job; j <= last_job; j++) members += cohort_job_count(k, j);
+    }
+
+    if (count >= notables + members) return notables;
+    int quota = cohort_binomial(count, (double)notables / (double)(notables + members));
+    if (quota > notables) quota = notables;
+    if (count - quota > members) quota = count - (int)members;
+    return quota;
+}
@@ -1,18 +1,116 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <unistd.h>
 #include "../humans.h"
 #include "../game_config.h"
+#include "../rng.h"
+#include "../workers.h"
+#include "../cohorts.h"
+#include "../lifecycle.h"
 
 void life(struct HumanPopulation *world) {
     world->human_population = INITIAL_POPULATION;
 }
 
+// --- Details table ---
+
+#define DETAILS_FREE -1     // Entry owner while the entry is free
+#define DETAILS_MOVING -2   // Entry owner while the population is being moved
+
+/**
+ * @brief Starts moving the population: every details entry waits for its owner to claim
+ * it again at their new index (see details_end_move).
+ */
+static void details_begin_move(struct Human_Data *data)
+{
+    for (int e = 1; e < data->details_count; e++) {
+        if (data->details[e].owner != DETAILS_FREE) data->details[e].owner = DETAILS_MOVING;
+    }
+}
+
+/**
+ * @brief Frees the entries nobody claimed while the population moved: their owners were dropped.
+ */
+static void details_end_move(struct Human_Data *data)
+{
+    for (int e = 1; e < data->details_count; e++) {
+        if (data->details[e].owner == DETAILS_MOVING) {
+            data->details[e].owner = DETAILS_FREE;
+            data->details[e].next_free = data->details_free;
+            data->details_free = e;
+        }
+    }
+}
+
+/**
+ * @brief Takes a free details entry for humans[index], growing the table if needed.
+ * Speed, smart and quirks are drawn here, in the first citizens' range, the first time
+ * anything asks for them.
+ * @return The new handle, or 0 if the table could not grow.
+ */
+static int create_details(struct Human_Data *data, int index, const char *name)
+{
+    int handle = data->details_free;
+    if (handle != 0) {
+        data->details_free = data->details[handle].next_free;
+    } else {
+        if (data->details_count == 0) data->details_count = 1; // Handle 0 means "none"
+        if (data->details_count >= data->details_capacity) {
+            int new_capacity = data->details_capacity > 0 ? data->details_capacity * 2 : 64;
+            void *temp_ptr = realloc(data->details, new_capacity * sizeof(struct Human_Details));
+            if (temp_ptr == NULL) {
+                fprintf(stderr, "Error: Failed to reallocate memory for human details.\n");
+                return 0;
+            }
+            data->details = temp_ptr;
+            data->details_capacity = new_capacity;
+        }
+        handle = data->details_count++;
+    }
+
+    struct Human_Details *details = &data->details[handle];
+    memset(details, 0, sizeof(*details));
+    uint32_t draws[3];
+    rng_fill(&g_sim_rng, draws, 3);
+    details->owner = index;
+    details->name = (name != NULL) ? name : "Adam";
+    details->speed = (draws[0] % 30) + 1;
+    details->smart = (draws[1] % 30) + 1;
+    details->quirks[0] = draws[2] & 1;
+    details->quirks[1] = (draws[2] >> 1) & 1;
+    details->quirks[2] = (draws[2] >> 2) & 1;
+    data->humans[index].details = handle;
+    return handle;
+}
+
+/**
+ * @brief The identity, progression and equipment of humans[index], created on first use.
+ * Only the simulation thread may call this. @return NULL if the table could not grow.
+ */
+struct Human_Details *human_details(struct Human_Data *data, int index)
+{
+    int handle = data->humans[index].details;
+    if (handle == 0) handle = create_details(data, index, NULL);
+    return (handle != 0) ? &data->details[handle] : NULL;
+}
+
 /*
 With my GODLY power I move the dead guys to the back.
 of the pointer. Using this sorting algorithm. (Forgot the name)
 */
 void compact_dead_humans(struct Human_Data *data) {
+    // Once the world is split into kingdom shards, compacting means regrouping them.
+    if (data->is_sharded) {
+        shard_population_by_kingdom(data);
+        return;
+    }
+
     int write_index = 0;
+    details_begin_move(data);
+    int *moved_to = human_scratch(data, data->count); // For the calendar of deaths; it rebuilds without
     
     // Compact: move all living humans to the front
     for (int read_index = 0; read_index < data->count; read_index++) {
@@ -20,13 +118,22 @@ void compact_dead_humans(struct Human_Data *data) {
             if (write_index != read_index) {
                 data->humans[write_index] = data->humans[read_index];
             }
+            if (data->humans[write_index].details != 0) data->details[data->humans[write_index].details].owner = write_index;
+            if (moved_to != NULL) moved_to[read_index] = write_index;
             write_index++;
+        } else if (moved_to != NULL) {
+            moved_to[read_index] = -1;
         }
     }
+    details_end_move(data);
     
     // Update count to only living humans
     int old_count = data->count;
     data->count = write_index;
+    if (write_index != old_count) {
+        data->layout_generation++;
+        if (moved_to != NULL) lifecycle_moved(data, data->layout_generation - 1, moved_to, old_count);
+    }
     
     // No need to reallocate here, we can just use less of the existing buffer.
     // The buffer will grow again naturally via the persona function when needed.
@@ -34,139 +141,472 @@ void compact_dead_humans(struct Human_Data *data) {
     //       old_count, data->count, old_count - data->count);
 }
 
+/**
+ * @brief One regroup of the population, split into fixed-size chunks for the worker pool.
+ * Every chunk counts its own citizens per kingdom, and a prefix sum over the chunks gives
+ * each chunk its own write position in every shard, so the scatter needs no locking.
+ * The chunks (and their random streams) don't depend on the number of workers, so the
+ * result is the same on any machine.
+ */
+struct ShardPartition {
+    struct Human_Data *data;
+    struct Human_Stats *regrouped;
+    int *moved_to;                       // Everyone's new index, or -1 if dropped (may be NULL)
+    int (*chunk_counts)[NUM_KINGDOMS];   // Citizens per kingdom in each chunk, then write positions
+    const int *shard_starts;             // NUMA mode: where the new shards begin, and their sizes
+    const int *shard_capacities;
+    shard_reassign_fn reassign;
+    void *context;
+    uint64_t seed;
+};
+
+/**
+ * @brief Reassigns the living citizens of one chunk, if asked to, and adds them to `counts`.
+ */
+static void reassign_and_count(const struct ShardPartition *part, int chunk, int counts[NUM_KINGDOMS]) {
+    struct Human_Data *data = part->data;
+    int begin = chunk * SHARD_PARTITION_CHUNK;
+    int end = begin + SHARD_PARTITION_CHUNK;
+    if (end > data->count) end = data->count;
+
+    struct RngStream rng;
+    if (part->reassign != NULL) rng_seed(&rng, part->seed + (uint64_t)chunk);
+
+    for (int i = begin; i < end; i++) {
+        struct Human_Stats *human = &data->humans[i];
+        if (human->alive != 1) continue;
+        if (part->reassign != NULL) part->reassign(human, &rng, part->context);
+        if (human->kingdom_id >= 0 && human->kingdom_id < NUM_KINGDOMS) counts[human->kingdom_id]++;
+    }
+}
+
+static void partition_count_chunk(int chunk, void *context) {
+    struct ShardPartition *part = context;
+    reassign_and_count(part, chunk, part->chunk_counts[chunk]);
+}
+
+static void partition_scatter_chunk(int chunk, void *context) {
+    struct ShardPartition *part = context;
+    struct Human_Data *data = part->data;
+    int begin = chunk * SHARD_PARTITION_CHUNK;
+    int end = begin + SHARD_PARTITION_CHUNK;
+    if (end > data->count) end = data->count;
+
+    int *fill = part->chunk_counts[chunk];
+    for (int i = begin; i < end; i++) {
+        const struct Human_Stats *human = &data->humans[i];
+        int position = -1;
+        if (human->alive == 1 && human->kingdom_id >= 0 && human->kingdom_id < NUM_KINGDOMS) {
+            position = fill[human->kingdom_id]++;
+            part->regrouped[position] = *human;
+            // Every entry has one owner, so no two workers write the same one
+            if (human->details != 0) data->details[human->details].owner = position;
+        }
+        if (part->moved_to != NULL) part->moved_to[i] = position;
+    }
+}
+
+/**
+ * @brief NUMA mode: touches every page of one kingdom's new shard first, from the worker that
+ * runs that kingdom's daily council (task k of every per-kingdom run), so the shard's
+ * memory is placed on that worker's node.
+ */
+static void partition_touch_shard(int kingdom_id, void *context) {
+    struct ShardPartition *part = context;
+    char *begin = (char *)&part->regrouped[part->shard_starts[kingdom_id]];
+    char *end = (char *)&part->regrouped[part->shard_starts[kingdom_id] + part->shard_capacities[kingdom_id]];
+    long page_size = sysconf(_SC_PAGESIZE);
+    for (volatile char *byte = begin; byte < end; byte += page_size) *byte = 0;
+}
+
+/**
+ * @brief Radix regroup of the living population into one contiguous shard per kingdom.
+ * Dead humans are dropped on the way. Each shard gets some free room at its end, and
+ * `extra_slots` more for `extra_kingdom` (-1 for none). If `reassign` is given it is
+ * called on every living human first and may move them to another kingdom.
+ * @param census If not NULL, receives the living citizens of every kingdom, even on failure.
+ * @return false if the new storage could not be allocated (the old layout is kept).
+ */
+static bool regroup_kingdom_shards(struct Human_Data *data, int extra_kingdom, int extra_slots,
+                                   shard_reassign_fn reassign, void *context, int census[NUM_KINGDOMS])
+{
+    int chunk_count = (data->count + SHARD_PARTITION_CHUNK - 1) / SHARD_PARTITION_CHUNK;
+    struct ShardPartition part = { data, NULL, NULL, NULL, NULL, NULL, reassign, context, 0 };
+    if (reassign != NULL) part.seed = ((uint64_t)rng_next(&g_sim_rng) << 32) | rng_next(&g_sim_rng);
+
+    part.chunk_counts = calloc(chunk_count > 0 ? chunk_count : 1, sizeof(*part.chunk_counts));
+    if (part.chunk_counts == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for the kingdom shards.\n");
+        // The citizens still change kingdoms and are counted, chunk by chunk on this thread
+        int sizes[NUM_KINGDOMS] = {0};
+        for (int c = 0; c < chunk_count; c++) reassign_and_count(&part, c, sizes);
+        if (census != NULL) memcpy(census, sizes, sizeof(sizes));
+        return false;
+    }
+
+    // 1. Count the living citizens of every kingdom, chunk by chunk
+    workers_run(chunk_count, partition_count_chunk, &part);
+
+    // 2. Lay the shards out one after the other, and give every chunk its place inside them
+    int sizes[NUM_KINGDOMS] = {0};
+    int capacities[NUM_KINGDOMS];
+    int starts[NUM_KINGDOMS];
+    for (int c = 0; c < chunk_count; c++) {
+        for (int k = 0; k < NUM_KINGDOMS; k++) sizes[k] += part.chunk_counts[c][k];
+    }
+    if (census != NULL) memcpy(census, sizes, sizeof(sizes));
+
+    int total = 0;
+    for (int k = 0; k < NUM_KINGDOMS; k++) {
+        int slack = sizes[k] * SHARD_SLACK_PERCENT / 100;
+        if (slack < SHARD_MIN_SLACK) slack = SHARD_MIN_SLACK;
+        capacities[k] = sizes[k] + slack + (k == extra_kingdom ? extra_slots : 0);
+        starts[k] = total;
+        total += capacities[k];
+    }
+    for (int k = 0; k < NUM_KINGDOMS; k++) {
+        int position = starts[k];
+        for (int c = 0; c < chunk_count; c++) {
+            int chunk_size = part.chunk_counts[c][k];
+            part.chunk_counts[c][k] = position;
+            position += chunk_size;
+        }
+    }
+
+    // Zeroed memory makes every unused slot a dead placeholder.
+    part.regrouped = calloc(total, sizeof(struct Human_Stats));
+    if (part.regrouped == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for the kingdom shards.\n");
+        free(part.chunk_counts);
+        return false;
+    }
+
+    // 3. Scatter every living citizen into their kingdom's shard
+    if (workers_numa()) {
+        part.shard_starts = starts;
+        part.shard_capacities = capacities;
+        workers_run(NUM_KINGDOMS, partition_touch_shard, &part);
+    }
+    // The calendar of deaths follows the moves, unless citizens changed kingdoms: then it
+    // rebuilds, which also moves them to their new kingdom's age pyramid
+    int old_count = data->count;
+    if (reassign == NULL) part.moved_to = human_scratch(data, old_count);
+    details_begin_move(data);
+    workers_run(chunk_count, partition_scatter_chunk, &part);
+    details_end_move(data);
+    free(part.chunk_counts);
+
+    free(data->humans);
+    data->humans = part.regrouped;
+    data->count = total;
+    data->capacity = total;
+    data->is_sharded = true;
+    data->layout_generation++;
+    for (int k = 0; k < NUM_KINGDOMS; k++) {
+        data->shard_start[k] = starts[k];
+        data->shard_size[k] = sizes[k];
+        data->shard_capacity[k] = capacities[k];
+    }
+    if (part.moved_to != NULL) lifecycle_moved(data, data->layout_generation - 1, part.moved_to, old_count);
+    return true;
+}
+
+/**
+ * @brief Splits the world into kingdom shards. Called by the daily compaction to drop the
+ * dead and renew every shard's free room.
+ */
+void shard_population_by_kingdom(struct Human_Data *data)
+{
+    regroup_kingdom_shards(data, -1, 0, NULL, NULL, NULL);
+}
+
+/**
+ * @brief Moves the living population to new kingdoms and shards it in the same pass.
+ * Used when the Empire falls. `reassign` runs on the worker threads, with a random stream
+ * of its own for each chunk of the population.
+ * @param census Receives the living citizens of every kingdom, even if the regroup fails.
+ */
+bool repartition_population(struct Human_Data *data, shard_reassign_fn reassign, void *context, int census[NUM_KINGDOMS])
+{
+    return regroup_kingdom_shards(data, -1, 0, reassign, context, census);
+}
+
+/**
+ * @brief The scratch buffer, with room for at least `count` ints. It only grows when the
+ * population does, so the passes that use it every hour don't allocate.
+ * @return NULL if it could not grow.
+ */
+int *human_scratch(struct Human_Data *data, int count)
+{
+    if (count <= data->scratch_capacity) return data->scratch;
+
+    int new_capacity = count * HUMAN_ARRAY_GROWTH_FACTOR;
+    int *grown = realloc(data->scratch, new_capacity * sizeof(int));
+    if (grown == NULL) {
+        fprintf(stderr, "Error: Failed to reallocate the scratch buffer.\n");
+        return NULL;
+    }
+    data->scratch = grown;
+    data->scratch_capacity = new_capacity;
+    return grown;
+}
+
+/**
+ * @brief Makes sure the array can hold at least `required_capacity` humans.
+ */
+static bool grow_population_storage(struct Human_Data *data, int required_capacity)
+{
+    if (required_capacity <= data->capacity) return true;
+
+    int new_capacity = required_capacity * HUMAN_ARRAY_GROWTH_FACTOR; // Grow by 50% to avoid frequent reallocs
+    void *temp_ptr = realloc(data->humans, new_capacity * sizeof(struct Human_Stats));
+    if (temp_ptr == NULL) {
+        fprintf(stderr, "Error: Failed to reallocate memory for new humans.\n");
+        return false;
+    }
+    data->humans = temp_ptr;
+    data->capacity = new_capacity;
+    return true;
+}
+
+/**
+ * @brief Reserves `count` consecutive slots for new citizens of a kingdom.
+ * Before the collapse this appends to the array. Afterwards the slots come from the
+ * free room of the kingdom's shard, regrouping the shards when it runs out.
+ * @return The index of the first reserved slot, or -1 on failure.
+ */
+int reserve_kingdom_slots(struct Human_Data *data, int kingdom_id, int count)
+{
+    if (count <= 0) return -1;
+
+    if (!data->is_sharded) {
+        if (!grow_population_storage(data, data->count + count)) return -1;
+        int start_index = data->count;
+        data->count += count;
+        return start_index;
+    }
+
+    if (kingdom_id < 0 || kingdom_id >= NUM_KINGDOMS) return -1;
+    if (data->shard_size[kingdom_id] + count > data->shard_capacity[kingdom_id]) {
+        if (!regroup_kingdom_shards(data, kingdom_id, count, NULL, NULL, NULL)) return -1;
+    }
+
+    int start_index = data->shard_start[kingdom_id] + data->shard_size[kingdom_id];
+    data->shard_size[kingdom_id] += count;
+    return start_index;
+}
+
+/**
+ * @brief The part of humans[] that can hold citizens of a kingdom: its shard once the
+ * world is sharded, otherwise the whole array. Callers still check kingdom_id.
+ */
+void kingdom_range(const struct Human_Data *data, int kingdom_id, int *begin, int *end)
+{
+    if (data->is_sharded && kingdom_id >= 0 && kingdom_id < NUM_KINGDOMS) {
+        *begin = data->shard_start[kingdom_id];
+        *end = data->shard_start[kingdom_id] + data->shard_size[kingdom_id];
+    } else {
+        *begin = 0;
+        *end = data->count;
+    }
+}
+
+#define SPAWN_DRAW_BLOCK 256      // Humans per block of random numbers
+#define SPAWN_DRAWS_PER_HUMAN 4   // Two attributes and two for the lifespan
+
+/**
+ * @brief One bulk spawn, split into fixed-size chunks for the worker pool. Every chunk
+ * has its own random stream, so the result doesn't depend on the number of workers.
+ */
+struct SpawnBatch {
+    struct Human_Data *data;
+    const struct SpawnTemplate *template;
+    int kingdom_id;
+    int start_index;
+    int count;
+    uint64_t seed;
+};
+
+static void spawn_chunk(int chunk, void *context)
+{
+    const struct SpawnBatch *batch = context;
+    const struct SpawnTemplate *template = batch->template;
+    int begin = chunk * SPAWN_CHUNK;
+    int end = begin + SPAWN_CHUNK;
+    if (end > batch->count) end = batch->count;
+
+    struct RngStream rng;
+    rng_seed(&rng, batch->seed + (uint64_t)chunk);
+
+    // Everything the template fixes is written once here and copied from then on
+    struct Human_Stats base;
+    memset(&base, 0, sizeof(base));
+    base.health = template->health;
+    base.hunger = template->hunger;
+    base.job = template->job;
+    base.is_general = template->is_general;
+    base.bronze = template->bronze;
+    base.kingdom_id = batch->kingdom_id;
+    base.alive = 1;
+    uint32_t range = template->stat_range > 0 ? (uint32_t)template->stat_range : 1;
+
+    // The random attributes and the lifespan, drawn a block at a time
+    uint32_t draws[SPAWN_DRAWS_PER_HUMAN * SPAWN_DRAW_BLOCK];
+    for (int i = begin; i < end; i += SPAWN_DRAW_BLOCK) {
+        int block = (end - i < SPAWN_DRAW_BLOCK) ? end - i : SPAWN_DRAW_BLOCK;
+        rng_fill(&rng, draws, SPAWN_DRAWS_PER_HUMAN * block);
+        struct Human_Stats *human = &batch->data->humans[batch->start_index + i];
+        for (int n = 0; n < block; n++, human++) {
+            const uint32_t *d = &draws[SPAWN_DRAWS_PER_HUMAN * n];
+            *human = base;
+            human->damage = template->stat_min + (int)(d[0] % range);
+            human->defense = template->stat_min + (int)(d[1] % range);
+            lifecycle_set_lifespan(human, d[2], d[3], template->newborn);
+        }
+    }
+}
+
+/**
+ * @brief Creates `count` humans of a kingdom from a template. Storage is reserved once, the
+ * attributes and lifespans are drawn in blocks on the worker pool (which also touches the
+ * new memory first), and the new humans join the calendar of deaths. Named humans get
+ * their details entry here; everyone else gets one when something first asks for it.
+ * Kingdom populations are left to the next census.
+ * @return The index of the first new human (they take [start, start + count)), or -1 on failure.
+ */
+int spawn_humans(struct Human_Data *data, const struct SpawnTemplate *template, int kingdom_id, int count)
+{
+    int start_index = reserve_kingdom_slots(data, kingdom_id, count);
+    if (start_index < 0) return -1;
+
+    struct SpawnBatch batch = { data, template, kingdom_id, start_index, count, 0 };
+    batch.seed = ((uint64_t)rng_next(&g_sim_rng) << 32) | rng_next(&g_sim_rng);
+    workers_run((count + SPAWN_CHUNK - 1) / SPAWN_CHUNK, spawn_chunk, &batch);
+
+    if (template->name != NULL) {
+        for (int i = start_index; i < start_index + count; i++) create_details(data, i, template->name);
+    }
+    lifecycle_schedule(data, start_index, count);
+    return start_index;
+}
+
 /*
 The first humans are created magically. I wonder who did it.
 data->count should be the global human population in integer.
+They are made a slice at a time, so `progress` (if given) can tell the GUI how far along it is.
+Each slice is drawn from its own seeds, so the world only depends on the seed, not on the threads.
 */
-void initialize_population(struct Human_Data *data)
-{
-    data->capacity = data->count; // Initial capacity is the starting population
-    // Loop through the entire starting population
-    for (int i = 0; i < data->count; i++)
-    {
-        struct Human_Stats human;
-        human.name = "Adam"; 
-        human.health = 200;
-        human.hunger = 100;
-        human.speed = (rand() % 30)+1;
-        human.damage = (rand() % 30)+1;
-        human.defense = (rand() % 30)+1;
-        human.smart = (rand() % 30)+1;
-        human.job = 0; // Unemployed
-        human.is_general = 0;
-        human.bronze = STARTING_BRONZE;
-        human.alive = 1;
-        human.kingdom_id = 0;
-        data->humans[i] = human;
+void initialize_population(struct Human_Data *data, progress_fn progress)
+{
+    static const struct SpawnTemplate first_humans = {
+        .name = NULL, .health = 200, .hunger = 100, .stat_min = 1, .stat_range = 30,
+        .job = 0, .bronze = STARTING_BRONZE, .newborn = false
+    };
+    int population = data->count;
+    data->capacity = population; // Initial capacity is the starting population
+    data->count = 0;
+    for (int done = 0; done < population; done += WORLD_GENERATION_SLICE) {
+        int slice = (population - done < WORLD_GENERATION_SLICE) ? population - done : WORLD_GENERATION_SLICE;
+        if (spawn_humans(data, &first_humans, 0, slice) < 0) return;
+        if (progress != NULL) progress(done + slice, population);
     }
 }
 
 /*
-This calculates deaths and births.
+This calculates deaths and births, kingdom by kingdom.
 Death by "Natural Causes" = Because so I felt like it.
 Birth by "Food Surplus" = Food production is going wild.
+Every kingdom keeps its own fractions of a birth or death for the next hour.
 */
-void calculate_stable_population_changes(struct Kingdom *kingdom, int current_population, int *out_births, int *out_deaths)
+void calculate_population_changes(struct Kingdom kingdoms[], int out_births[NUM_KINGDOMS], int out_deaths[NUM_KINGDOMS])
 {
-    if (current_population <= 0) {
-        *out_births = 0;
-        *out_deaths = 0;
-        return;
-    }
+    for (int k = 0; k < NUM_KINGDOMS; k++) {
+        struct Kingdom *kingdom = &kingdoms[k];
+        out_births[k] = 0;
+        out_deaths[k] = 0;
+        if (!kingdom->is_active || kingdom->population <= 0) continue;
 
-    // 1. Calculate Deaths from Natural Causes.
-    float daily_natural_deaths = (current_population * DAILY_NATURAL_DEATH_RATE_PER_1000) / DAYS_IN_MONTH;
-    float hourly_natural_deaths = daily_natural_deaths / ACTIVE_HOURS_PER_DAY;
-    static float death_fraction = 0.0;
-    death_fraction += hourly_natural_deaths;
-    *out_deaths = (int)death_fraction;
-    if (*out_deaths > 0) {
-        death_fraction -= *out_deaths;
-    }
+        // 1. Calculate Deaths from Natural Causes.
+        float daily_natural_deaths = (kingdom->population * DAILY_NATURAL_DEATH_RATE_PER_1000) / DAYS_IN_MONTH;
+        kingdom->death_fraction += daily_natural_deaths / ACTIVE_HOURS_PER_DAY;
+        out_deaths[k] = (int)kingdom->death_fraction;
+        kingdom->death_fraction -= out_deaths[k];
 
-    // 2. Calculate Births based on Food Surplus.
-    int food_surplus = kingdom->food - current_population;
-    if (food_surplus < 0) food_surplus = 0;
-    float daily_births_from_surplus = food_surplus / FOOD_SURPLUS_PER_BIRTH;
-    float hourly_births = daily_births_from_surplus / ACTIVE_HOURS_PER_DAY;
-    static float birth_fraction = 0.0;
-    birth_fraction += hourly_births;
-    *out_births = (int)birth_fraction;
-    if (*out_births > 0) {
-        birth_fraction -= *out_births;
-    }
-
-    if (current_population < POPULATION_GROWTH_FLOOR && *out_deaths > *out_births) {
-        *out_deaths = *out_births; 
+        // 2. Calculate Births based on the kingdom's own Food Surplus.
+        int food_surplus = kingdom->food - kingdom->population;
+        if (food_surplus < 0) food_surplus = 0;
+        float daily_births_from_surplus = food_surplus / FOOD_SURPLUS_PER_BIRTH;
+        kingdom->birth_fraction += daily_births_from_surplus / ACTIVE_HOURS_PER_DAY;
+        out_births[k] = (int)kingdom->birth_fraction;
+        kingdom->birth_fraction -= out_births[k];
     }
 }
 
-void persona(int new_births, struct HumanPopulation *world_stat, struct Human_Data *data, int empire_has_fallen)
+/**
+ * @brief Newborns of every kingdom, each group placed straight into its kingdom's part of the array.
+ */
+void persona(const int births[NUM_KINGDOMS], struct HumanPopulation *world_stat, struct Human_Data *data)
 {
-    if (new_births <= 0) return;
-
-    // --- Capacity-based reallocation ---
-    int required_capacity = data->count + new_births;
-    if (required_capacity > data->capacity) {
-        int new_capacity = required_capacity * HUMAN_ARRAY_GROWTH_FACTOR; // Grow by 50% to avoid frequent reallocs
-        void *temp_ptr = realloc(data->humans, new_capacity * sizeof(struct Human_Stats));
-        if (temp_ptr == NULL) {
-            fprintf(stderr, "Error: Failed to reallocate memory for new humans.\n");
-            return; 
-        }
-        data->humans = temp_ptr;
-        data->capacity = new_capacity;
-    }
-
-    int start_index = data->count;
-    data->count += new_births;
-    world_stat->human_population = data->count;
-
-    for (int i = start_index; i < data->count; i++)
-    {
-        struct Human_Stats human;
-        human.name = "Adam"; 
-        human.health = 200;
-        human.hunger = 100;
-        human.speed = rand() % 10;
-        human.damage = rand() % 10;
-        human.defense = rand() % 10;
-        human.smart = rand() % 10;
-        human.job = 0; // Unemployed
-        human.is_general = 0;
-        human.bronze = STARTING_BRONZE;
-        human.alive = 1;
-        human.quirks[0] = rand() % 2;
-        human.quirks[1] = rand() % 2;
-        human.quirks[2] = rand() % 2;
-        
-        if (empire_has_fallen) {
-            human.kingdom_id = (rand() % 7) + 1;
-        } else {
-            human.kingdom_id = 0;
-        }
-        data->humans[i] = human;
+    static const struct SpawnTemplate newborn = {
+        .name = NULL, .health = 200, .hunger = 100, .stat_min = 0, .stat_range = 10,
+        .job = 0, .bronze = STARTING_BRONZE, .newborn = true
+    };
+    for (int k = 0; k < NUM_KINGDOMS; k++) {
+        if (births[k] <= 0) continue;
+        if (spawn_humans(data, &newborn, k, births[k]) < 0) continue;
+        world_stat->human_population += births[k];
     }
 }
 
 /**
  * @brief Marks a specific number of living humans as deceased.
+ * In cohort mode the notables in humans[] take their share and the cohorts lose the rest.
  */
 void alive_status(int deaths_to_inflict, struct Human_Data *data)
 {
     if (deaths_to_inflict <= 0) return;
 
     int casualties = 0;
+    int individual_deaths = g_cohorts.enabled ? cohort_notable_quota(data, -1, 0, JOB_REBEL, deaths_to_inflict) : deaths_to_inflict;
     // This has better cache performance and avoids hitting the same dead person multiple times.
-    int start_index = rand() % data->count;
+    int start_index = (data->count > 0) ? rand() % data->count : 0;
     for (int i = 0; i < data->count; i++) {
-        if (casualties >= deaths_to_inflict) break;
+        if (casualties >= individual_deaths) break;
 
         int current_index = (start_index + i) % data->count;
         if (data->humans[current_index].alive == 1) {
+            lifecycle_remove(&data->humans[current_index]);
             data->humans[current_index].alive = 0;
             data->humans[current_index].job = 0;
             casualties++;
         }
     }
-}
\ No newline at end of file
+    if (g_cohorts.enabled && casualties < deaths_to_inflict) {
+        cohort_natural_deaths(deaths_to_inflict - casualties);
+    }
+}
+
+/**
+ * @brief Natural deaths for the coming `hours`. Citizens die when their lifespan runs out;
+ * the cohorts have no ages and lose the kingdoms' `steady_deaths` at the steady rate instead.
+ * While the world is below POPULATION_GROWTH_FLOOR deaths don't exceed the births.
+ * @return The number of deaths.
+ */
+int natural_deaths(struct Human_Data *data, const int steady_deaths[NUM_KINGDOMS], const int births[NUM_KINGDOMS],
+                   int population, int day, int hour, int hours)
+{
+    int total_deaths = 0, total_births = 0;
+    for (int k = 0; k < NUM_KINGDOMS; k++) {
+        total_deaths += steady_deaths[k];
+        total_births += births[k];
+    }
+    int max_deaths = (population < POPULATION_GROWTH_FLOOR) ? total_births : INT_MAX;
+
+    if (g_cohorts.enabled) {
+        // The rate is the same for everyone, so the world-wide draw matches per-kingdom ones
+        if (total_deaths > max_deaths) total_deaths = max_deaths;
+        alive_status(total_deaths, data);
+        return total_deaths;
+    }
+    return lifecycle_natural_deaths(data, day, hour, hours, max_deaths);
+}
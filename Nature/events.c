@@ -6,6 +6,8 @@
 #include "../events.h"
 #include "../logger.h"
 #include "../game_config.h"
+#include "../cohorts.h"
+#include "../lifecycle.h"
 
 // --- Helper Functions ---
 
@@ -16,18 +18,26 @@ static void kill_random_civilians(struct Kingdom *kingdom, struct Human_Data *da
     if (count <= 0) return;
     int casualties = 0;
     int attempts = 0;
-    while (casualties < count && attempts < data->count * 2) {
-        int rand_idx = rand() % data->count;
+    int begin, end;
+    kingdom_range(data, kingdom->id, &begin, &end);
+    int span = end - begin;
+    int individual_count = g_cohorts.enabled ? cohort_notable_quota(data, kingdom->id, JOB_FARMER, JOB_BLACKSMITH, count) : count;
+    while (span > 0 && casualties < individual_count && attempts < span * 2) {
+        int rand_idx = begin + rand() % span;
         // Target is alive, belongs to the kingdom, and is a civilian (job 1-5)
         if (data->humans[rand_idx].alive == 1 &&
             data->humans[rand_idx].kingdom_id == kingdom->id &&
             data->humans[rand_idx].job >= 1 && data->humans[rand_idx].job <= 5)
         {
+            lifecycle_remove(&data->humans[rand_idx]);
             data->humans[rand_idx].alive = 0;
             casualties++;
         }
         attempts++;
     }
+    if (g_cohorts.enabled && casualties < count) {
+        casualties += cohort_kill(kingdom->id, JOB_FARMER, JOB_BLACKSMITH, count - casualties, false);
+    }
     log_event(" -> A disaster has claimed the lives of %d civilians in %s.\n", casualties, kingdom->name);
 }
 
@@ -42,11 +52,14 @@ static void event_bountiful_harvest(struct Kingdom *kingdom) {
 
 static void event_discovery_of_gold(struct Kingdom *kingdom, struct Human_Data *data) {
     log_event("EVENT: A vein of gold discovery in %s!\n", kingdom->name);
-    for (int i = 0; i < data->count; i++) {
+    int begin, end;
+    kingdom_range(data, kingdom->id, &begin, &end);
+    for (int i = begin; i < end; i++) {
         if (data->humans[i].alive == 1 && data->humans[i].kingdom_id == kingdom->id) {
             data->humans[i].bronze += GOLD_DISCOVERY_BRONZE_BONUS; // Give a nice bonus to everyone
         }
     }
+    if (g_cohorts.enabled) cohort_add_bronze(kingdom->id, GOLD_DISCOVERY_BRONZE_BONUS);
 }
 
 static void event_plague(struct Kingdom *kingdom, struct Human_Data *data) {
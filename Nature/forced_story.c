@@ -4,6 +4,7 @@
 #include "../forced_story.h"
 #include "../logger.h"
 #include "../shared_data.h"
+#include "../cohorts.h"
 
 
 int ch_1_3 = 0;
@@ -23,6 +24,10 @@ static void add_people_with_job(int count, int job_id, int kingdom_id, struct Hu
     if (count <= 0) return;
 
     int converted = 0;
+    // In cohort mode the masses answer first, so the notables keep their roles
+    for (int j = 0; g_cohorts.enabled && j <= JOB_REBEL && converted < count; j++) {
+        converted += cohort_move_jobs(kingdom_id, j, job_id, count - converted);
+    }
     // Convert ANY living person in the kingdom, regardless of current job
     for (int i = 0; i < data->count && converted < count; i++) {
         if (data->humans[i].alive == 1 && data->humans[i].kingdom_id == kingdom_id) {
@@ -102,6 +107,16 @@ void apply_story_effects(int chapter_index, int paragraph_index, struct Kingdom
     }
 }
 
+void get_story_effects_fired(int fired[STORY_EFFECT_COUNT]) {
+    fired[0] = ch_1_3; fired[1] = ch_1_7; fired[2] = ch_1_9;
+    fired[3] = ch_8_0; fired[4] = ch_8_12; fired[5] = ch_8_26;
+}
+
+void set_story_effects_fired(const int fired[STORY_EFFECT_COUNT]) {
+    ch_1_3 = fired[0]; ch_1_7 = fired[1]; ch_1_9 = fired[2];
+    ch_8_0 = fired[3]; ch_8_12 = fired[4]; ch_8_26 = fired[5];
+}
+
 // Stop any fights for 1 hour (5secs)- set_skirmish_control(empire, -1, 1.0);
 // Halve production and cap food at 2000 - set_production_control(empire, 0.5, 2000);
 // Triple skirmish chance - set_skirmish_control(empire, 0, 3.0);
\ No newline at end of file
@@ -0,0 +1,237 @@
+// file: lifecycle.c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../lifecycle.h"
+#include "../game_config.h"
+#include "../calculations.h"
+#include "../rng.h"
+
+struct LifeCalendar g_life_calendar;
+
+#define LIFE_BUCKET_MIN_CAPACITY 64
+#define LIFE_DRAW_BLOCK 256 // Lives started per block of random numbers
+
+/**
+ * @brief Sets the calendar's first day. Call before anyone is born or arrives.
+ */
+void lifecycle_init(int day)
+{
+    g_life_calendar.today = day;
+    g_life_calendar.built = false;
+}
+
+static void bucket_push(struct LifeBucket *bucket, int index)
+{
+    if (bucket->count == bucket->capacity) {
+        int new_capacity = bucket->capacity > 0 ? bucket->capacity * 2 : LIFE_BUCKET_MIN_CAPACITY;
+        int *grown = realloc(bucket->indices, new_capacity * sizeof(int));
+        if (grown == NULL) {
+            fprintf(stderr, "Error: Failed to allocate memory for the calendar of deaths.\n");
+            return; // The next rebuild schedules them again
+        }
+        bucket->indices = grown;
+        bucket->capacity = new_capacity;
+    }
+    bucket->indices[bucket->count++] = index;
+}
+
+static int pyramid_slot(int birth_day)
+{
+    int slot = birth_day % LIFE_PYRAMID_DAYS;
+    return slot < 0 ? slot + LIFE_PYRAMID_DAYS : slot;
+}
+
+/**
+ * @brief Adds a living citizen to their kingdom's age pyramid (`delta` 1) or takes them out (-1).
+ */
+static void pyramid_count(const struct Human_Stats *human, int delta)
+{
+    struct LifeCalendar *calendar = &g_life_calendar;
+    if (human->kingdom_id < 0 || human->kingdom_id >= NUM_KINGDOMS) return;
+
+    int age = calendar->today - human->birth_day;
+    int band = age / AGE_BAND_DAYS;
+    if (band < 0) band = 0;
+    if (band >= LIFE_AGE_BANDS) band = LIFE_AGE_BANDS - 1;
+    calendar->age_pyramid[human->kingdom_id][band] += delta;
+    if (age >= 0 && age < LIFE_PYRAMID_DAYS) calendar->recent_births[human->kingdom_id][pyramid_slot(human->birth_day)] += delta;
+}
+
+/**
+ * @brief Puts a citizen whose life just started into the calendar, if they die inside it.
+ * If the calendar is out of date, its next rebuild finds them instead.
+ */
+static void schedule_death(struct Human_Data *data, int index)
+{
+    struct LifeCalendar *calendar = &g_life_calendar;
+    if (!calendar->built || calendar->built_generation != data->layout_generation) return;
+
+    int day = data->humans[index].death_day;
+    if (day >= calendar->built_until) return;
+    if (day < calendar->today) day = calendar->today;
+    bucket_push(&calendar->buckets[day % LIFE_CALENDAR_DAYS], index);
+}
+
+/**
+ * @brief Gives one human a lifespan from two random numbers. Newborns start at age 0;
+ * everyone else (the first citizens, recruits, promoted notables) appears already grown,
+ * at a random point of their lifespan. Safe to call from the worker threads.
+ */
+void lifecycle_set_lifespan(struct Human_Stats *human, uint32_t lifespan_draw, uint32_t age_draw, bool newborn)
+{
+    int lifespan = AVERAGE_LIFESPAN_DAYS - LIFESPAN_SPREAD_DAYS + (int)(lifespan_draw % (2 * LIFESPAN_SPREAD_DAYS + 1));
+    int age = newborn ? 0 : (int)(age_draw % lifespan);
+    human->birth_day = g_life_calendar.today - age;
+    human->death_day = human->birth_day + lifespan;
+}
+
+/**
+ * @brief Puts humans[start_index .. start_index + count), whose lifespans are set, into the calendar
+ * and the age pyramid.
+ */
+void lifecycle_schedule(struct Human_Data *data, int start_index, int count)
+{
+    if (!g_life_calendar.built) return; // The first rebuild will find them
+    for (int i = start_index; i < start_index + count; i++) {
+        pyramid_count(&data->humans[i], 1);
+        schedule_death(data, i);
+    }
+}
+
+/**
+ * @brief Takes a citizen who died or left humans[] out of the age pyramid.
+ */
+void lifecycle_remove(const struct Human_Stats *human)
+{
+    if (g_life_calendar.built) pyramid_count(human, -1); // Otherwise the first rebuild counts the living
+}
+
+/**
+ * @brief Points the buckets at everyone's new index and drops those who are gone. If the
+ * calendar didn't follow the layout before the move, the next rebuild sorts it out instead.
+ */
+void lifecycle_moved(const struct Human_Data *data, unsigned old_generation, const int *moved_to, int old_count)
+{
+    struct LifeCalendar *calendar = &g_life_calendar;
+    if (!calendar->built || calendar->built_generation != old_generation) return;
+
+    for (int d = 0; d < LIFE_CALENDAR_DAYS; d++) {
+        struct LifeBucket *bucket = &calendar->buckets[d];
+        int kept = 0;
+        for (int n = 0; n < bucket->count; n++) {
+            int index = bucket->indices[n];
+            if (index < 0 || index >= old_count || moved_to[index] < 0) continue;
+            bucket->indices[kept++] = moved_to[index];
+        }
+        bucket->count = kept;
+    }
+    calendar->built_generation = data->layout_generation;
+}
+
+/**
+ * @brief Starts the lives of humans[start_index .. start_index + count) on the simulation thread.
+ */
+void lifecycle_start(struct Human_Data *data, int start_index, int count, bool newborn)
+{
+    uint32_t draws[2 * LIFE_DRAW_BLOCK];
+    for (int done = 0; done < count; done += LIFE_DRAW_BLOCK) {
+        int block = (count - done < LIFE_DRAW_BLOCK) ? count - done : LIFE_DRAW_BLOCK;
+        rng_fill(&g_sim_rng, draws, 2 * block);
+        for (int n = 0; n < block; n++) {
+            lifecycle_set_lifespan(&data->humans[start_index + done + n], draws[2 * n], draws[2 * n + 1], newborn);
+        }
+    }
+    lifecycle_schedule(data, start_index, count);
+}
+
+/**
+ * @brief Refills the buckets from the whole population and counts the age pyramids again.
+ */
+static void rebuild_calendar(struct Human_Data *data)
+{
+    struct LifeCalendar *calendar = &g_life_calendar;
+    for (int d = 0; d < LIFE_CALENDAR_DAYS; d++) calendar->buckets[d].count = 0;
+    memset(calendar->age_pyramid, 0, sizeof(calendar->age_pyramid));
+    memset(calendar->recent_births, 0, sizeof(calendar->recent_births));
+    calendar->built_until = calendar->today + LIFE_CALENDAR_DAYS;
+
+    for (int i = 0; i < data->count; i++) {
+        const struct Human_Stats *human = &data->humans[i];
+        if (human->alive != 1) continue;
+
+        pyramid_count(human, 1);
+
+        if (human->death_day < calendar->built_until) {
+            int day = (human->death_day < calendar->today) ? calendar->today : human->death_day;
+            bucket_push(&calendar->buckets[day % LIFE_CALENDAR_DAYS], i);
+        }
+    }
+    calendar->built_generation = data->layout_generation;
+    calendar->built = true;
+}
+
+/**
+ * @brief Moves the calendar on to `day`. Whoever was due on the days left behind but
+ * was held back (see max_deaths) dies on the new day instead. Everyone born on a
+ * band's first day moves up to the next band of the age pyramid.
+ */
+static void advance_calendar(int day)
+{
+    struct LifeCalendar *calendar = &g_life_calendar;
+    while (calendar->today < day) {
+        struct LifeBucket *left = &calendar->buckets[calendar->today % LIFE_CALENDAR_DAYS];
+        calendar->today++;
+        struct LifeBucket *next = &calendar->buckets[calendar->today % LIFE_CALENDAR_DAYS];
+        for (int n = 0; n < left->count; n++) bucket_push(next, left->indices[n]);
+        left->count = 0;
+
+        // The slot of today was last used by those now too old to move up again
+        int today_slot = pyramid_slot(calendar->today);
+        for (int k = 0; k < NUM_KINGDOMS; k++) {
+            calendar->recent_births[k][today_slot] = 0;
+            for (int band = 1; band < LIFE_AGE_BANDS; band++) {
+                int grown = calendar->recent_births[k][pyramid_slot(calendar->today - band * AGE_BAND_DAYS)];
+                calendar->age_pyramid[k][band - 1] -= grown;
+                calendar->age_pyramid[k][band] += grown;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Natural deaths for `hours` hours starting at `hour` of `day`. Today's bucket is
+ * spread over the hours left in the day, so it is empty by midnight.
+ * @param max_deaths Most deaths allowed; those held back die later.
+ * @return The number of citizens who died.
+ */
+int lifecycle_natural_deaths(struct Human_Data *data, int day, int hour, int hours, int max_deaths)
+{
+    struct LifeCalendar *calendar = &g_life_calendar;
+    advance_calendar(day);
+    if (!calendar->built || calendar->built_generation != data->layout_generation || day >= calendar->built_until) {
+        rebuild_calendar(data);
+    }
+
+    int hours_left = DAY_IN_HOURS - hour;
+    if (hours_left < 1) hours_left = 1;
+    if (hours > hours_left) hours = hours_left;
+
+    struct LifeBucket *bucket = &calendar->buckets[day % LIFE_CALENDAR_DAYS];
+    int due = (bucket->count * hours + hours_left - 1) / hours_left;
+    if (due > max_deaths) due = max_deaths;
+
+    int deaths = 0;
+    while (deaths < due && bucket->count > 0) {
+        int index = bucket->indices[--bucket->count];
+        if (index >= data->count) continue;
+        struct Human_Stats *human = &data->humans[index];
+        if (human->alive != 1 || human->death_day > day) continue; // Already gone another way
+        lifecycle_remove(human);
+        human->alive = 0;
+        human->job = 0;
+        deaths++;
+    }
+    return deaths;
+}
@@ -0,0 +1,226 @@
+// file: font_cache.c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Same Nuklear configuration as main.c, so the font structs match.
+#define NK_INCLUDE_FIXED_TYPES
+#define NK_INCLUDE_STANDARD_IO
+#define NK_INCLUDE_STANDARD_VARARGS
+#define NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+#define NK_INCLUDE_FONT_BAKING
+#define NK_INCLUDE_DEFAULT_FONT
+#include "../GUI_lib/nuklear.h"
+
+#include "font_cache.h"
+
+#define FONT_CACHE_MAGIC "VLFATLS"
+#define FONT_CACHE_VERSION 1
+#define FONT_CACHE_ALIGN 16
+
+struct FontCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t glyph_size;   // sizeof(struct nk_font_glyph) of the build that wrote it
+    uint64_t key;
+    int32_t width, height;
+    float null_u, null_v;
+    int32_t font_count;
+    int32_t glyph_count;
+};
+
+struct FontCacheRecord {
+    float pixel_height;
+    float height, ascent, descent;
+    uint32_t glyph_offset, glyph_count;
+    uint32_t fallback;
+    uint32_t unused;
+};
+
+static size_t align_up(size_t offset)
+{
+    return (offset + FONT_CACHE_ALIGN - 1) & ~(size_t)(FONT_CACHE_ALIGN - 1);
+}
+
+// Where each part of the file starts
+static void cache_layout(int font_count, int glyph_count, size_t *glyphs_at, size_t *image_at)
+{
+    size_t records_at = align_up(sizeof(struct FontCacheHeader));
+    *glyphs_at = align_up(records_at + font_count * sizeof(struct FontCacheRecord));
+    *image_at = align_up(*glyphs_at + glyph_count * sizeof(struct nk_font_glyph));
+}
+
+static uint64_t hash_bytes(uint64_t hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < size; i++) hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    return hash;
+}
+
+/**
+ * @brief Hashes the font file together with the sizes and glyph ranges it is baked with.
+ * @return The key, or 0 if the font file can't be read.
+ */
+uint64_t font_cache_key(const char *font_path, const float pixel_heights[], int font_count, const nk_rune *ranges)
+{
+    FILE *file = fopen(font_path, "rb");
+    if (file == NULL) return 0;
+
+    uint64_t hash = 14695981039346656037ULL;
+    unsigned char buffer[16384];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) hash = hash_bytes(hash, buffer, read);
+    fclose(file);
+
+    hash = hash_bytes(hash, &font_count, sizeof(font_count));
+    hash = hash_bytes(hash, pixel_heights, font_count * sizeof(float));
+    for (const nk_rune *range = ranges; *range != 0; range++) hash = hash_bytes(hash, range, sizeof(*range));
+    return hash != 0 ? hash : 1;
+}
+
+/**
+ * @brief Maps the cache file and checks that it was baked from the same font, sizes and ranges.
+ * On success the cache's fonts are ready for nk_font_init; keep it open while they are in use,
+ * and don't copy it: the fonts point at its configs.
+ */
+bool font_cache_load(const char *cache_path, uint64_t key, const nk_rune *ranges, struct FontCache *cache)
+{
+    memset(cache, 0, sizeof(*cache));
+    int fd = open(cache_path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    void *mapping = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(struct FontCacheHeader)) {
+        mapping = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (mapping == MAP_FAILED) return false;
+
+    size_t size = (size_t)info.st_size;
+    const struct FontCacheHeader *header = mapping;
+    size_t glyphs_at = 0, image_at = 0;
+    bool valid = memcmp(header->magic, FONT_CACHE_MAGIC, sizeof(header->magic)) == 0 &&
+                 header->version == FONT_CACHE_VERSION &&
+                 header->glyph_size == sizeof(struct nk_font_glyph) &&
+                 header->key == key &&
+                 header->font_count > 0 && header->font_count <= FONT_CACHE_MAX_FONTS &&
+                 header->glyph_count > 0 && header->width > 0 && header->height > 0;
+    if (valid) {
+        cache_layout(header->font_count, header->glyph_count, &glyphs_at, &image_at);
+        valid = image_at + (size_t)header->width * header->height * 4 <= size;
+    }
+    if (!valid) {
+        munmap(mapping, size);
+        return false;
+    }
+
+    const struct FontCacheRecord *records = (const struct FontCacheRecord *)((const char *)mapping + align_up(sizeof(*header)));
+    cache->mapping = mapping;
+    cache->mapping_size = size;
+    cache->width = header->width;
+    cache->height = header->height;
+    cache->image = (const char *)mapping + image_at;
+    cache->null_uv = nk_vec2(header->null_u, header->null_v);
+    cache->glyphs = (struct nk_font_glyph *)((char *)mapping + glyphs_at); // Nuklear only reads them
+    cache->font_count = header->font_count;
+    for (int i = 0; i < cache->font_count; i++) {
+        if (records[i].glyph_offset + records[i].glyph_count > (uint32_t)header->glyph_count) {
+            font_cache_close(cache);
+            return false;
+        }
+        cache->pixel_heights[i] = records[i].pixel_height;
+        cache->fonts[i].info.height = records[i].height;
+        cache->fonts[i].info.ascent = records[i].ascent;
+        cache->fonts[i].info.descent = records[i].descent;
+        cache->fonts[i].info.glyph_offset = records[i].glyph_offset;
+        cache->fonts[i].info.glyph_count = records[i].glyph_count;
+        cache->fonts[i].info.ranges = ranges;
+        cache->fonts[i].fallback_codepoint = records[i].fallback;
+
+        struct nk_font_config *config = &cache->configs[i];
+        config->size = records[i].pixel_height;
+        config->range = ranges;
+        config->fallback_glyph = records[i].fallback;
+        config->font = &cache->fonts[i].info;
+        config->n = config->p = config;
+        cache->fonts[i].config = config;
+    }
+    return true;
+}
+
+/**
+ * @brief Writes a freshly baked atlas to the cache. Call between nk_font_atlas_bake and
+ * nk_font_atlas_end, while the image and the white pixel's position are still there.
+ * A failure only costs the next start another bake, so it is reported and ignored.
+ */
+void font_cache_save(const char *cache_path, uint64_t key, const struct nk_font_atlas *atlas, const void *image, int width, int height)
+{
+    struct FontCacheHeader header;
+    struct FontCacheRecord records[FONT_CACHE_MAX_FONTS];
+    memset(&header, 0, sizeof(header));
+    memset(records, 0, sizeof(records));
+
+    int font_count = 0;
+    for (const struct nk_font *font = atlas->fonts; font != NULL; font = font->next) {
+        if (font_count == FONT_CACHE_MAX_FONTS) return;
+        struct FontCacheRecord *record = &records[font_count++];
+        record->pixel_height = font->config->size;
+        record->height = font->info.height;
+        record->ascent = font->info.ascent;
+        record->descent = font->info.descent;
+        record->glyph_offset = font->info.glyph_offset;
+        record->glyph_count = font->info.glyph_count;
+        record->fallback = font->fallback_codepoint;
+    }
+    if (font_count == 0 || image == NULL) return;
+
+    memcpy(header.magic, FONT_CACHE_MAGIC, sizeof(header.magic));
+    header.version = FONT_CACHE_VERSION;
+    header.glyph_size = sizeof(struct nk_font_glyph);
+    header.key = key;
+    header.width = width;
+    header.height = height;
+    header.null_u = (atlas->custom.x + 0.5f) / (float)width;
+    header.null_v = (atlas->custom.y + 0.5f) / (float)height;
+    header.font_count = font_count;
+    header.glyph_count = atlas->glyph_count;
+
+    size_t glyphs_at, image_at;
+    cache_layout(font_count, atlas->glyph_count, &glyphs_at, &image_at);
+    size_t size = image_at + (size_t)width * height * 4;
+    char *contents = calloc(1, size);
+    if (contents == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for the font cache.\n");
+        return;
+    }
+    memcpy(contents, &header, sizeof(header));
+    memcpy(contents + align_up(sizeof(header)), records, font_count * sizeof(struct FontCacheRecord));
+    memcpy(contents + glyphs_at, atlas->glyphs, atlas->glyph_count * sizeof(struct nk_font_glyph));
+    memcpy(contents + image_at, image, (size_t)width * height * 4);
+
+    // Written beside the cache and renamed over it, so a reader never sees half a file
+    char temporary_path[4096];
+    snprintf(temporary_path, sizeof(temporary_path), "%s.tmp", cache_path);
+    FILE *file = fopen(temporary_path, "wb");
+    bool written = file != NULL && fwrite(contents, 1, size, file) == size;
+    if (file != NULL && fclose(file) != 0) written = false;
+    if (written && rename(temporary_path, cache_path) == 0) {
+        printf("Saved the baked fonts to '%s'.\n", cache_path);
+    } else {
+        fprintf(stderr, "Warning: Could not write the font cache '%s'.\n", cache_path);
+        remove(temporary_path);
+    }
+    free(contents);
+}
+
+void font_cache_close(struct FontCache *cache)
+{
+    if (cache->mapping != NULL) munmap(cache->mapping, cache->mapping_size);
+    memset(cache, 0, sizeof(*cache));
+}
@@ -0,0 +1,35 @@
+#ifndef FONT_CACHE_H
+#define FONT_CACHE_H
+
+// --- Baked font atlas cache ---
+// Baking the story fonts is the slowest part of opening the window. The baked atlas image
+// and glyph tables are saved next to the font file, and the next start maps that file
+// and hands it to the GPU as it is. The cache is keyed by a hash of the font file, the
+// pixel sizes and the glyph ranges, so changing any of them bakes the atlas again.
+// Needs the same Nuklear configuration as main.c before it is included.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define FONT_CACHE_MAX_FONTS 4
+
+struct FontCache {
+    void *mapping;                                // The mapped cache file
+    size_t mapping_size;
+    int width, height;                            // Atlas image, RGBA32
+    const void *image;
+    struct nk_vec2 null_uv;                       // Texture coordinates of the atlas' white pixel
+    struct nk_font_glyph *glyphs;                 // All fonts' glyphs, inside the mapping
+    int font_count;
+    float pixel_heights[FONT_CACHE_MAX_FONTS];
+    struct nk_font fonts[FONT_CACHE_MAX_FONTS];   // info, fallback_codepoint and config filled in
+    struct nk_font_config configs[FONT_CACHE_MAX_FONTS]; // Glyph lookup walks the font's config ranges
+};
+
+uint64_t font_cache_key(const char *font_path, const float pixel_heights[], int font_count, const nk_rune *ranges);
+bool font_cache_load(const char *cache_path, uint64_t key, const nk_rune *ranges, struct FontCache *cache);
+void font_cache_save(const char *cache_path, uint64_t key, const struct nk_font_atlas *atlas, const void *image, int width, int height);
+void font_cache_close(struct FontCache *cache);
+
+#endif // FONT_CACHE_H
@@ -0,0 +1,88 @@
+// file: history_gui.c
+
+#include <stdbool.h>
+
+// Same Nuklear configuration as main.c, so the context's layout matches.
+#define NK_INCLUDE_FIXED_TYPES
+#define NK_INCLUDE_STANDARD_IO
+#define NK_INCLUDE_STANDARD_VARARGS
+#define NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+#define NK_INCLUDE_FONT_BAKING
+#define NK_INCLUDE_DEFAULT_FONT
+#include "../GUI_lib/nuklear.h"
+
+#include "../game_config.h"
+#include "../calculations.h"
+#include "../app_state.h"
+#include "../history.h"
+#include "history_gui.h"
+
+#define HISTORY_WINDOW_WIDTH 900
+#define HISTORY_WINDOW_HEIGHT 500
+#define HISTORY_CHART_HEIGHT 340
+
+static const char *const kingdom_names[NUM_KINGDOMS] = {
+    "The Great Empire", "Successor Kingdom 1", "Successor Kingdom 2", "Successor Kingdom 3",
+    "Successor Kingdom 4", "Successor Kingdom 5", "Successor Kingdom 6", "Successor Kingdom 7",
+};
+static const char *const span_names[] = {"Last week", "Last year", "All time"};
+static const int span_hours[] = {DAY_IN_HOURS * 7, DAY_IN_HOURS * 365, 0};
+
+void draw_history_window(struct nk_context *ctx, struct AppState *state, float screen_width, float screen_height)
+{
+    struct nk_rect bounds = nk_rect((screen_width - HISTORY_WINDOW_WIDTH) / 2.0f, (screen_height - HISTORY_WINDOW_HEIGHT) / 2.0f,
+                                    HISTORY_WINDOW_WIDTH, HISTORY_WINDOW_HEIGHT);
+    if (!nk_begin(ctx, "History", bounds, NK_WINDOW_BORDER | NK_WINDOW_MOVABLE | NK_WINDOW_CLOSABLE | NK_WINDOW_TITLE)) {
+        state->show_history_window = false;
+        nk_end(ctx);
+        return;
+    }
+
+    const char *metric_names[HISTORY_METRICS];
+    for (int m = STARTING_ZERO; m < HISTORY_METRICS; m++) metric_names[m] = history_metric_name((enum HistoryMetric)m);
+
+    nk_layout_row_dynamic(ctx, 30, 3);
+    state->history_kingdom = nk_combo(ctx, kingdom_names, NUM_KINGDOMS, state->history_kingdom, 25, nk_vec2(nk_widget_width(ctx), 240));
+    state->history_metric = nk_combo(ctx, metric_names, HISTORY_METRICS, state->history_metric, 25, nk_vec2(nk_widget_width(ctx), 140));
+    state->history_span = nk_combo(ctx, span_names, (int)(sizeof(span_names) / sizeof(span_names[0])), state->history_span, 25, nk_vec2(nk_widget_width(ctx), 110));
+
+    // One point per pixel is as much as the chart can show
+    nk_layout_row_dynamic(ctx, HISTORY_CHART_HEIGHT, STARTING_ONE);
+    int max_points = (int)nk_layout_widget_bounds(ctx).w;
+    if (max_points > HISTORY_MAX_POINTS) max_points = HISTORY_MAX_POINTS;
+    static struct HistorySample points[HISTORY_MAX_POINTS];
+    int count = history_snapshot(state->history_kingdom, (enum HistoryMetric)state->history_metric, span_hours[state->history_span], max_points, points);
+
+    if (count == STARTING_ZERO) {
+        nk_label(ctx, "No history yet.", NK_TEXT_CENTERED);
+        nk_end(ctx);
+        return;
+    }
+
+    float lowest = points[POSITION_ZERO].min, highest = points[POSITION_ZERO].max;
+    for (int i = STARTING_ONE; i < count; i++) {
+        if (points[i].min < lowest) lowest = points[i].min;
+        if (points[i].max > highest) highest = points[i].max;
+    }
+    float chart_top = (highest > lowest) ? highest : lowest + 1.0f; // A flat line still needs a range
+
+    const struct nk_color mean_color = nk_rgb(230, 190, 90), range_color = nk_rgb(120, 90, 50), hover_color = nk_rgb(255, 255, 255);
+    int hovered = -STARTING_ONE;
+    if (nk_chart_begin_colored(ctx, NK_CHART_LINES, mean_color, hover_color, count, lowest, chart_top)) {
+        nk_chart_add_slot_colored(ctx, NK_CHART_LINES, range_color, hover_color, count, lowest, chart_top);
+        nk_chart_add_slot_colored(ctx, NK_CHART_LINES, range_color, hover_color, count, lowest, chart_top);
+        for (int i = STARTING_ZERO; i < count; i++) {
+            nk_chart_push_slot(ctx, points[i].max, 1);
+            nk_chart_push_slot(ctx, points[i].min, 2);
+            if (nk_chart_push_slot(ctx, points[i].mean, 0) & NK_CHART_HOVERING) hovered = i;
+        }
+        nk_chart_end(ctx);
+    }
+    if (hovered >= STARTING_ZERO) {
+        nk_tooltipf(ctx, "Mean %.0f, lowest %.0f, highest %.0f", points[hovered].mean, points[hovered].min, points[hovered].max);
+    }
+
+    nk_layout_row_dynamic(ctx, 25, STARTING_ONE);
+    nk_labelf(ctx, NK_TEXT_LEFT, "Now: %.0f    Lowest: %.0f    Highest: %.0f", points[count - STARTING_ONE].mean, lowest, highest);
+    nk_end(ctx);
+}
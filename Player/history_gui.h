@@ -0,0 +1,15 @@
+#ifndef HISTORY_GUI_H
+#define HISTORY_GUI_H
+
+// --- History window ---
+// Charts one kingdom's population, unrest, treasury or food over the last week, the last
+// year or the whole run. Each frame asks the history store for about one point per pixel
+// of the chart and draws the mean with the lowest and highest values around it.
+
+struct nk_context;
+struct AppState;
+
+// Draws the window while state->show_history_window is set and clears it when it is closed.
+void draw_history_window(struct nk_context *ctx, struct AppState *state, float screen_width, float screen_height);
+
+#endif // HISTORY_GUI_H
@@ -0,0 +1,214 @@
+// file: log_view.c
+
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+
+// Same Nuklear configuration as main.c, so the context's layout matches.
+#define NK_INCLUDE_FIXED_TYPES
+#define NK_INCLUDE_STANDARD_IO
+#define NK_INCLUDE_STANDARD_VARARGS
+#define NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+#define NK_INCLUDE_FONT_BAKING
+#define NK_INCLUDE_DEFAULT_FONT
+#include "../GUI_lib/nuklear.h"
+
+#include "../logger.h"
+#include "log_view.h"
+
+#define LOG_VIEW_MAX_LINES 32 // Lines one message may be broken into; the rest is clipped
+
+struct LogViewEntry {
+    char message[LOG_MESSAGE_LENGTH];
+    int line_count;
+    unsigned char line_start[LOG_VIEW_MAX_LINES];
+    unsigned char line_length[LOG_VIEW_MAX_LINES];
+};
+
+// Only the GUI thread touches the view.
+static struct {
+    struct LogViewEntry entries[MAX_LOG_ENTRIES]; // Ring, oldest at `first`
+    int first_line[MAX_LOG_ENTRIES];              // Line the entry starts on, counted from the oldest entry
+    int first;
+    int count;
+    int total_lines;
+    unsigned long sequence;                       // g_log_sequence the copy is up to
+    unsigned int expiry_generation;
+    float wrap_width;                             // Width the lines were broken for
+    bool synced;
+} view;
+
+/**
+ * @brief Breaks one message into lines that fit `width`, at spaces where possible.
+ */
+static void wrap_entry(struct LogViewEntry *entry, const struct nk_user_font *font, float width)
+{
+    const char *text = entry->message;
+    int length = (int)strlen(text);
+    int start = 0;
+    entry->line_count = 0;
+
+    while (start < length && entry->line_count < LOG_VIEW_MAX_LINES) {
+        int end = start;
+        int last_space = -1;
+        // Grow the line one character at a time while it still fits
+        while (end < length) {
+            if (text[end] == ' ') last_space = end;
+            if (end > start && font->width(font->userdata, font->height, text + start, end + 1 - start) > width) break;
+            end++;
+        }
+        if (end < length && last_space > start) end = last_space; // Break at the last space instead of inside a word
+        if (entry->line_count == LOG_VIEW_MAX_LINES - 1) end = length;
+
+        entry->line_start[entry->line_count] = (unsigned char)start;
+        entry->line_length[entry->line_count] = (unsigned char)(end - start);
+        entry->line_count++;
+
+        start = end;
+        while (start < length && text[start] == ' ') start++;
+    }
+    if (entry->line_count == 0) { // Empty message still takes a line
+        entry->line_start[0] = 0;
+        entry->line_length[0] = 0;
+        entry->line_count = 1;
+    }
+}
+
+/**
+ * @brief Recounts where every entry starts. Cheap next to wrapping: one add per entry.
+ */
+static void count_lines(void)
+{
+    int line = 0;
+    for (int n = 0; n < view.count; n++) {
+        int slot = (view.first + n) % MAX_LOG_ENTRIES;
+        view.first_line[n] = line;
+        line += view.entries[slot].line_count;
+    }
+    view.total_lines = line;
+}
+
+/**
+ * @brief Appends a copy of one log message, dropping the oldest when the view is full.
+ * Like the log itself, the view keeps at most MAX_LOG_ENTRIES - 1 messages.
+ */
+static void push_entry(const LogEntry *source, const struct nk_user_font *font)
+{
+    if (view.count == MAX_LOG_ENTRIES - 1) {
+        view.first = (view.first + 1) % MAX_LOG_ENTRIES;
+        view.count--;
+    }
+    struct LogViewEntry *entry = &view.entries[(view.first + view.count) % MAX_LOG_ENTRIES];
+    memcpy(entry->message, source->message, LOG_MESSAGE_LENGTH);
+    entry->message[LOG_MESSAGE_LENGTH - 1] = '\0';
+    wrap_entry(entry, font, view.wrap_width);
+    view.count++;
+}
+
+/**
+ * @brief Copies the messages logged since the last frame. Starts over from the whole
+ * log when old messages were cleared or more were written than the log holds.
+ */
+static void sync_with_log(const struct nk_user_font *font)
+{
+    bool changed = false;
+
+    pthread_mutex_lock(&g_event_log_mutex);
+    unsigned long missed = g_log_sequence - view.sequence;
+    if (!view.synced || view.expiry_generation != g_log_expiry_generation || missed >= MAX_LOG_ENTRIES) {
+        view.first = 0;
+        view.count = 0;
+        for (int i = g_log_read_index; i != g_log_write_index; i = (i + 1) % MAX_LOG_ENTRIES) {
+            if (g_log_entries[i].timestamp > 0) push_entry(&g_log_entries[i], font);
+        }
+        changed = true;
+    } else if (missed > 0) {
+        int i = (g_log_write_index - (int)missed + MAX_LOG_ENTRIES) % MAX_LOG_ENTRIES;
+        for (; i != g_log_write_index; i = (i + 1) % MAX_LOG_ENTRIES) {
+            if (g_log_entries[i].timestamp > 0) push_entry(&g_log_entries[i], font);
+        }
+        changed = true;
+    }
+    view.sequence = g_log_sequence;
+    view.expiry_generation = g_log_expiry_generation;
+    view.synced = true;
+    pthread_mutex_unlock(&g_event_log_mutex);
+
+    if (changed) count_lines();
+}
+
+/**
+ * @brief Finds the entry holding `line` (counted from the oldest entry).
+ */
+static int entry_for_line(int line)
+{
+    int low = 0, high = view.count - 1;
+    while (low < high) {
+        int middle = (low + high + 1) / 2;
+        if (view.first_line[middle] <= line) low = middle;
+        else high = middle - 1;
+    }
+    return low;
+}
+
+/**
+ * @brief Leaves empty space for `lines` rows that are not drawn.
+ */
+static void skip_rows(struct nk_context *ctx, int lines, float pitch, float spacing)
+{
+    if (lines <= 0) return;
+    nk_layout_row_dynamic(ctx, lines * pitch - spacing, 1);
+    nk_spacing(ctx, 1);
+}
+
+/**
+ * @brief Draws the event log, oldest message first. Only the rows inside the group's
+ * visible area become widgets; the rest are stood in for by two empty rows, so the
+ * scrollbar still covers the whole log.
+ */
+void draw_log_view(struct nk_context *ctx, const char *group_name)
+{
+    const struct nk_user_font *font = ctx->style.font;
+    float row_height = font->height + 2 * ctx->style.text.padding.y;
+    float spacing = ctx->style.window.spacing.y;
+    float pitch = row_height + spacing;
+
+    nk_layout_row_dynamic(ctx, row_height, 1);
+    float width = nk_layout_widget_bounds(ctx).w - 2 * ctx->style.text.padding.x;
+    if (width < 1) width = 1;
+
+    if (width != view.wrap_width) {
+        view.wrap_width = width;
+        for (int n = 0; n < view.count; n++) {
+            wrap_entry(&view.entries[(view.first + n) % MAX_LOG_ENTRIES], font, width);
+        }
+        count_lines();
+    }
+    sync_with_log(font);
+    if (view.total_lines == 0) return;
+
+    nk_uint scroll_x, scroll_y;
+    nk_group_get_scroll(ctx, group_name, &scroll_x, &scroll_y);
+    int visible = (int)(nk_window_get_content_region(ctx).h / pitch) + 2;
+    int top = (int)(scroll_y / pitch);
+    if (top > view.total_lines - visible) top = view.total_lines - visible; // Scrolled to the end
+    if (top < 0) top = 0;
+    int bottom = top + visible;
+    if (bottom > view.total_lines) bottom = view.total_lines;
+
+    skip_rows(ctx, top, pitch, spacing);
+
+    nk_layout_row_dynamic(ctx, row_height, 1);
+    int n = entry_for_line(top);
+    int line = top - view.first_line[n];
+    for (int row = top; row < bottom; row++) {
+        const struct LogViewEntry *entry = &view.entries[(view.first + n) % MAX_LOG_ENTRIES];
+        nk_text(ctx, entry->message + entry->line_start[line], entry->line_length[line], NK_TEXT_LEFT);
+        if (++line == entry->line_count) {
+            n++;
+            line = 0;
+        }
+    }
+
+    skip_rows(ctx, view.total_lines - bottom, pitch, spacing);
+}
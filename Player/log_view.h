@@ -0,0 +1,14 @@
+#ifndef LOG_VIEW_H
+#define LOG_VIEW_H
+
+// --- Event log view ---
+// Keeps its own copy of the event log with every message already broken into lines,
+// so a frame only copies the messages written since the last one and only draws the
+// lines that are inside the scrolled view. Lines are broken again when the width changes.
+
+struct nk_context;
+
+// Call between nk_group_begin and nk_group_end of the group named `group_name`.
+void draw_log_view(struct nk_context *ctx, const char *group_name);
+
+#endif // LOG_VIEW_H
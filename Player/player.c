@@ -1,4 +1,8 @@
+#include <pthread.h>
 #include "../player.h"
+#include "../humans.h"
+#include "../game_config.h"
+#include "../logger.h"
 
 void player_setup(struct PlayerStat *theplayer)
 {
@@ -23,4 +27,68 @@ void player_setup(struct PlayerStat *theplayer)
     // Items
     theplayer->current_player_right = 0;
     theplayer->current_player_left = 0;
-}
\ No newline at end of file
+}
+
+// Orders queued by the GUI thread, taken by the simulation thread
+static struct {
+    pthread_mutex_t mutex;
+    int commands[PLAYER_COMMAND_QUEUE];
+    int count;
+} queue = { .mutex = PTHREAD_MUTEX_INITIALIZER };
+
+/**
+ * @brief Queues an order for the simulation's next hour.
+ * @return 1 if it was queued, 0 if the queue is full.
+ */
+int player_queue_command(int command)
+{
+    pthread_mutex_lock(&queue.mutex);
+    int queued = queue.count < PLAYER_COMMAND_QUEUE;
+    if (queued) queue.commands[queue.count++] = command;
+    pthread_mutex_unlock(&queue.mutex);
+    return queued;
+}
+
+/**
+ * @brief Takes the queued orders, oldest first. Returns how many were copied into `commands`.
+ */
+int player_take_commands(int commands[], int max)
+{
+    pthread_mutex_lock(&queue.mutex);
+    int taken = queue.count < max ? queue.count : max;
+    for (int i = 0; i < taken; i++) commands[i] = queue.commands[i];
+    for (int i = taken; i < queue.count; i++) queue.commands[i - taken] = queue.commands[i];
+    queue.count -= taken;
+    pthread_mutex_unlock(&queue.mutex);
+    return taken;
+}
+
+/**
+ * @brief How many orders are waiting for the simulation's next hour.
+ */
+int player_commands_waiting(void)
+{
+    pthread_mutex_lock(&queue.mutex);
+    int waiting = queue.count;
+    pthread_mutex_unlock(&queue.mutex);
+    return waiting;
+}
+
+void player_carry_out_command(int command, struct Kingdom *kingdoms)
+{
+    struct Kingdom *empire = &kingdoms[0];
+    switch (command) {
+        case PLAYER_COMMAND_FESTIVAL:
+            if (empire->treasury < PLAYER_FESTIVAL_COST) {
+                log_event("The treasury can no longer pay for the festival.");
+                break;
+            }
+            empire->treasury -= PLAYER_FESTIVAL_COST;
+            empire->unrest_level -= PLAYER_FESTIVAL_UNREST_REDUCTION;
+            if (empire->unrest_level < 0) empire->unrest_level = 0;
+            log_event("A grand festival is held! The people rejoice and unrest falls.");
+            break;
+        default:
+            break;
+    }
+}
@@ -12,4 +12,8 @@ void draw_player_actions_panel(struct nk_context *ctx, struct AppState *state) {
     if (nk_button_label(ctx, "Manager")) {
         state->show_policies_window = true; // We still use the same state flag to open it
     }
+    nk_layout_row_dynamic(ctx, 40, 1);
+    if (nk_button_label(ctx, "History")) {
+        state->show_history_window = true;
+    }
 }
\ No newline at end of file
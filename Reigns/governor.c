@@ -0,0 +1,483 @@
+// file: governor.c
+
+#include <math.h>
+#include <time.h>
+#include "../governor.h"
+#include "../game_config.h"
+#include "../journal.h"
+#include "../rng.h"
+#include "../workers.h"
+
+#define PLAN_TASKS (GOVERNOR_ACTIONS * GOVERNOR_ROLLOUTS_PER_ROUND)
+
+// What one worker adds to and takes from the stores on an average day, from the job settings
+// in game_config.h: half the shifts are rested, an output of min + rand() % range averages
+// min + (range - 1) / 2, and a meal restores (rand() % 40) + 10 hunger, 29.5 on average.
+#define PLAN_WORK_SHARE 0.5
+#define PLAN_MEAL_HUNGER 29.5
+#define PLAN_FARMER_FOOD (PLAN_WORK_SHARE * (FARMER_FOOD_PRODUCTION - 1) / 2.0)
+#define PLAN_BUTCHER_FOOD (PLAN_WORK_SHARE * (BUTCHER_MEAT_PRODUCTION - 1) / 2.0)
+#define PLAN_LUMBERJACK_WOOD (PLAN_WORK_SHARE * (1 + (LUMBERJACK_WOOD_PRODUCTION - 1) / 2.0))
+#define PLAN_MINER_METAL (PLAN_WORK_SHARE * MINER_METAL_CHANCE_PERCENT / 100.0 * (1 + (MINER_METAL_PRODUCTION - 1) / 2.0))
+#define PLAN_BLACKSMITH_METAL (PLAN_WORK_SHARE * BLACKSMITH_METAL_NEEDS)
+#define PLAN_APPETITE(hunger_cost, rations) (PLAN_WORK_SHARE * (hunger_cost) / PLAN_MEAL_HUNGER * (rations))
+
+// How a rollout's last day is judged. Everything is relative, so kingdoms of any size compare.
+#define PLAN_COLLAPSE_PENALTY 10.0   // The kingdom fell to its rebels or its unrest
+#define PLAN_REBEL_WEIGHT 0.5        // Per rebel per soldier, up to two
+#define PLAN_FOOD_WEIGHT 0.25        // For a granary that lasts PLAN_FOOD_DAYS_GOAL days
+#define PLAN_FOOD_DAYS_GOAL 30.0
+#define PLAN_TREASURY_WEIGHT 0.1     // For a treasury that can pay for a divine intervention
+
+static const double civilian_appetite[JOB_BLACKSMITH + 1] = {
+    [JOB_FARMER] = PLAN_APPETITE(FARMER_HUNGER_COST, 2),
+    [JOB_BUTCHER] = PLAN_APPETITE(BUTCHER_HUNGER_COST, 2),
+    [JOB_LUMBERJACK] = PLAN_APPETITE(LUMBERJACK_HUNGER_COST, 2),
+    [JOB_MINER] = PLAN_APPETITE(MINER_HUNGER_COST, 2),
+    [JOB_BLACKSMITH] = PLAN_APPETITE(BLACKSMITH_HUNGER_COST, 2),
+};
+static const double soldier_appetite = PLAN_APPETITE(SOLDIER_HUNGER_COST, 2 + MILITARY_EXTRA_FOOD_CONSUMPTION);
+
+static struct {
+    int budget_ms;
+    struct timespec deadline; // End of the current council's planning time
+} governor = { .budget_ms = GOVERNOR_TIME_BUDGET_MS };
+
+void governor_set_budget(int milliseconds)
+{
+    governor.budget_ms = milliseconds > 0 ? milliseconds : 0;
+}
+
+void governor_begin_council(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &governor.deadline);
+    long long nanoseconds = governor.deadline.tv_nsec + (long long)governor.budget_ms * 1000000LL;
+    governor.deadline.tv_sec += nanoseconds / 1000000000LL;
+    governor.deadline.tv_nsec = nanoseconds % 1000000000LL;
+}
+
+static bool out_of_time(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec > governor.deadline.tv_sec ||
+           (now.tv_sec == governor.deadline.tv_sec && now.tv_nsec >= governor.deadline.tv_nsec);
+}
+
+/**
+ * @brief Tiers 2 and 3 of EmpireAI: answer the most urgent problem if one stands out,
+ * otherwise keep the army at its ideal size. Reads nothing but its arguments.
+ */
+int governor_heuristic(const struct Kingdom *kingdom, int soldier_count, int rebel_count, const char **reason)
+{
+    const char *unused;
+    if (reason == NULL) reason = &unused;
+    *reason = NULL;
+
+    int daily_food_consumption = kingdom->population + 1;
+    float food_days_left = (float)kingdom->food / daily_food_consumption;
+    float military_ratio = (float)soldier_count / (float)(rebel_count + 1);
+    float food_urgency = (food_days_left < AI_FOOD_DAYS_THRESHOLD) ? 1.0f - (food_days_left / AI_FOOD_DAYS_THRESHOLD) : 0.0f;
+    float unrest_urgency = (float)kingdom->unrest_level / (float)REBELLION_THRESHOLD;
+    float military_urgency = (military_ratio < 1.0f) ? 1.0f - military_ratio : 0.0f;
+
+    // Find the most urgent problem
+    float max_urgency = 0.0f;
+    if (food_urgency > max_urgency) max_urgency = food_urgency;
+    if (unrest_urgency > max_urgency) max_urgency = unrest_urgency;
+    if (military_urgency > max_urgency) max_urgency = military_urgency;
+
+    // Only act if the problem is significant enough to warrant a response.
+    if (max_urgency > AI_ACTION_THRESHOLD) {
+        if (military_urgency == max_urgency) {
+            *reason = "GOVERNOR: Prioritizing recruitment.";
+            return GOVERNOR_RECRUIT;
+        }
+        if (unrest_urgency == max_urgency && kingdom->treasury >= AI_FESTIVAL_COST) {
+            *reason = "GOVERNOR: Hosting festivals to calm the populace.";
+            return GOVERNOR_FESTIVAL;
+        }
+        if (food_urgency == max_urgency) {
+            *reason = "GOVERNOR: Assigning more workers to farms.";
+            return GOVERNOR_FEED;
+        }
+    }
+
+    // With no crisis, the army is built up to its ideal size relative to the population
+    float ideal_army_size = kingdom->population * AI_ARMY_SIZE_GOAL_PERCENT;
+    if (soldier_count < ideal_army_size) {
+        *reason = "GOVERNOR: The kingdom is stable.";
+        return GOVERNOR_RECRUIT;
+    }
+    return GOVERNOR_HOLD;
+}
+
+// --- Rollouts ---
+
+// A copy of a kingdom for one rollout: its own record, with its citizens counted per job
+struct PlanWorld {
+    struct Kingdom kingdom; // labor_force holds the civilians
+    int soldiers;
+    int rebels;
+    bool collapsed;
+};
+
+static double uniform01(struct RngStream *rng)
+{
+    return rng_next(rng) / 4294967296.0;
+}
+
+/**
+ * @brief Draws a binomial count: exactly for small expectations, as a normal for large ones.
+ */
+static int draw_count(struct RngStream *rng, int n, double p)
+{
+    if (n <= 0 || p <= 0.0) return 0;
+    if (p >= 1.0) return n;
+    double mean = n * p;
+    int count;
+    if (mean < 16.0) {
+        // Poisson by multiplying uniforms
+        double limit = exp(-mean), product = uniform01(rng);
+        for (count = 0; product > limit; count++) product *= uniform01(rng);
+    } else {
+        // Four uniforms make a normal that is good enough here
+        double sum = uniform01(rng) + uniform01(rng) + uniform01(rng) + uniform01(rng);
+        count = (int)lround(mean + (sum - 2.0) * sqrt(3.0) * sqrt(mean * (1.0 - p)));
+    }
+    if (count < 0) return 0;
+    return count < n ? count : n;
+}
+
+static int civilians(const struct PlanWorld *world)
+{
+    int total = 0;
+    for (int j = 0; j <= JOB_BLACKSMITH; j++) total += world->kingdom.labor_force[j];
+    return total;
+}
+
+/**
+ * @brief Takes `count` civilians out of their jobs, from every job in proportion to its size.
+ */
+static int take_civilians(struct PlanWorld *world, int count)
+{
+    int *force = world->kingdom.labor_force;
+    int total = civilians(world);
+    if (count > total) count = total;
+    int taken = 0;
+    for (int j = 0; j <= JOB_BLACKSMITH && total > 0; j++) {
+        int share = (int)((long long)count * force[j] / total);
+        force[j] -= share;
+        taken += share;
+    }
+    // Rounding leftovers come from the largest jobs
+    while (taken < count) {
+        int largest = 0;
+        for (int j = 1; j <= JOB_BLACKSMITH; j++) if (force[j] > force[largest]) largest = j;
+        force[largest]--;
+        taken++;
+    }
+    return count;
+}
+
+static void update_population(struct PlanWorld *world)
+{
+    world->kingdom.population = civilians(world) + world->soldiers + world->rebels;
+}
+
+/**
+ * @brief recruit_soldiers on a copy: each recruit picks a unit and joins if it can be paid for.
+ */
+static void recruit(struct PlanWorld *world, struct RngStream *rng)
+{
+    struct Kingdom *kingdom = &world->kingdom;
+    if (kingdom->population == 0 || kingdom->unrest_level < DISSENT_THRESHOLD / 2) return;
+
+    int recruits_wanted = 5 + (kingdom->unrest_level / 20);
+    int available = civilians(world) - kingdom->labor_force[0];
+    if (recruits_wanted > available) recruits_wanted = available;
+    if (recruits_wanted > DAILY_RECRUIT_POOL) recruits_wanted = DAILY_RECRUIT_POOL;
+
+    int recruited = 0;
+    for (int i = 0; i < recruits_wanted; i++) {
+        int unit_choice = rng_next(rng) % 3;
+        if (unit_choice == 0 && kingdom->metal >= COST_SWORDSMAN_METAL) {
+            kingdom->metal -= COST_SWORDSMAN_METAL;
+            recruited++;
+        } else if (unit_choice == 1 && kingdom->wood >= COST_ARCHER_WOOD) {
+            kingdom->wood -= COST_ARCHER_WOOD;
+            recruited++;
+        } else if (unit_choice == 2 && kingdom->metal >= COST_CAVALRY_METAL && kingdom->food >= COST_CAVALRY_FOOD) {
+            kingdom->metal -= COST_CAVALRY_METAL;
+            kingdom->food -= COST_CAVALRY_FOOD;
+            recruited++;
+        }
+    }
+    // Recruits come from the jobs, never from the unemployed
+    int unemployed = kingdom->labor_force[0];
+    kingdom->labor_force[0] = 0;
+    take_civilians(world, recruited);
+    kingdom->labor_force[0] = unemployed;
+    world->soldiers += recruited;
+}
+
+/**
+ * @brief rebalance_labor on a copy: the jobs move towards the governor's shares, as far as a
+ * day's candidates allow.
+ */
+static void shift_labor(struct PlanWorld *world)
+{
+    struct Kingdom *kingdom = &world->kingdom;
+    plan_labor_shares(kingdom);
+    int *force = kingdom->labor_force;
+    int employed = civilians(world) - force[0];
+    int surplus = 0;
+    for (int j = JOB_FARMER; j <= JOB_BLACKSMITH; j++) {
+        int excess = force[j] - (int)((long long)kingdom->labor_share[j] * employed / 1000);
+        if (excess <= 0) continue;
+        if (excess > LABOR_CANDIDATE_POOL) excess = LABOR_CANDIDATE_POOL;
+        force[j] -= excess;
+        surplus += excess;
+    }
+    for (int j = JOB_FARMER; j <= JOB_BLACKSMITH && surplus > 0; j++) {
+        int gap = (int)((long long)kingdom->labor_share[j] * employed / 1000) - force[j];
+        if (gap <= 0) continue;
+        if (gap > surplus) gap = surplus;
+        force[j] += gap;
+        surplus -= gap;
+    }
+    force[JOB_FARMER] += surplus;
+}
+
+static void carry_out(struct PlanWorld *world, int action, struct RngStream *rng)
+{
+    struct Kingdom *kingdom = &world->kingdom;
+    kingdom->labor_goal = LABOR_GOAL_NONE;
+    switch (action) {
+        case GOVERNOR_RECRUIT:
+            recruit(world, rng);
+            kingdom->labor_goal = LABOR_GOAL_ARM;
+            break;
+        case GOVERNOR_FESTIVAL:
+            kingdom->treasury -= AI_FESTIVAL_COST;
+            kingdom->unrest_level -= AI_FESTIVAL_UNREST_REDUCTION;
+            if (kingdom->unrest_level < 0) kingdom->unrest_level = 0;
+            break;
+        case GOVERNOR_FEED:
+            kingdom->labor_goal = LABOR_GOAL_FEED;
+            break;
+        default:
+            break;
+    }
+    shift_labor(world);
+}
+
+/**
+ * @brief One day of work and meals, the night's unrest and the day's chance of an event.
+ */
+static void live_day(struct PlanWorld *world, struct RngStream *rng)
+{
+    struct Kingdom *kingdom = &world->kingdom;
+    const int *force = kingdom->labor_force;
+
+    double modifier = kingdom->story_production_modifier;
+    if (kingdom->divine_penalty_timer_days > 0) modifier *= kingdom->divine_production_modifier;
+    kingdom->food += (int)((force[JOB_FARMER] * PLAN_FARMER_FOOD + force[JOB_BUTCHER] * PLAN_BUTCHER_FOOD) * modifier);
+    kingdom->wood += (int)(force[JOB_LUMBERJACK] * PLAN_LUMBERJACK_WOOD * modifier);
+    int metal_used = (int)(force[JOB_BLACKSMITH] * PLAN_BLACKSMITH_METAL);
+    kingdom->metal += (int)(force[JOB_MINER] * PLAN_MINER_METAL * modifier) - (metal_used < kingdom->metal ? metal_used : kingdom->metal);
+    if (kingdom->story_food_daily_cap > 0 && kingdom->food > kingdom->story_food_daily_cap) kingdom->food = kingdom->story_food_daily_cap;
+
+    double demand = world->soldiers * soldier_appetite;
+    for (int j = JOB_FARMER; j <= JOB_BLACKSMITH; j++) demand += force[j] * civilian_appetite[j];
+    if (kingdom->food >= demand) {
+        kingdom->food -= (int)demand;
+    } else {
+        // The hours the granary stood empty are hours of famine
+        int famine_hours = (int)(DAY_IN_HOURS * (1.0 - kingdom->food / demand));
+        kingdom->food = 0;
+        kingdom->unrest_level += famine_hours * UNREST_GAIN_FROM_FAMINE;
+        double survivors = pow(1.0 - FAMINE_POPULATION_LOSS_PERCENT / 100.0, famine_hours);
+        int soldier_deaths = (int)(world->soldiers * (1.0 - survivors));
+        int rebel_deaths = (int)(world->rebels * (1.0 - survivors));
+        world->soldiers -= soldier_deaths;
+        world->rebels -= rebel_deaths;
+        take_civilians(world, (int)(civilians(world) * (1.0 - survivors)));
+        update_population(world);
+    }
+
+    // About one point of unrest fades per day
+    for (int hour = 0; hour < DAY_IN_HOURS; hour++) {
+        if (kingdom->unrest_level > 0 && rng_next(rng) % HOURLY_UNREST_DECAY_CHANCE_DIVISOR == 0) kingdom->unrest_level--;
+    }
+
+    if (kingdom->population >= 50 && rng_next(rng) % 100 < DAILY_RANDOM_EVENT_CHANCE_PERCENT) {
+        switch (rng_next(rng) % TOTAL_RANDOM_EVENTS) {
+            case 0: kingdom->food += HARVEST_BASE_FOOD_GAIN + (int)(kingdom->population * HARVEST_POPULATION_FOOD_MULTIPLIER); break;
+            case 1: break; // Gold fills the citizens' purses, not the treasury
+            case 2:
+                take_civilians(world, (int)(kingdom->population * PLAGUE_POPULATION_LOSS_PERCENT));
+                kingdom->unrest_level += PLAGUE_UNREST_GAIN;
+                break;
+            case 3:
+                kingdom->food = (int)(kingdom->food * 0.15);
+                kingdom->unrest_level += DROUGHT_UNREST_GAIN;
+                break;
+            case 4:
+                take_civilians(world, (int)(kingdom->population * BARBARIAN_POPULATION_LOSS_PERCENT));
+                kingdom->wood = (int)(kingdom->wood * BARBARIAN_RAID_RESOURCE_LOSS_PERCENT);
+                kingdom->unrest_level += BARBARIAN_RAID_UNREST_GAIN;
+                break;
+            default: kingdom->unrest_level += POLITICAL_INTRIGUE_UNREST_GAIN; break;
+        }
+        update_population(world);
+    }
+}
+
+/**
+ * @brief The daily council on a copy: taxes, dissent and the standing recruitment drive,
+ * then the heuristic's action for the day, or all hands to the farms when food is short.
+ */
+static void council_day(struct PlanWorld *world, struct RngStream *rng)
+{
+    struct Kingdom *kingdom = &world->kingdom;
+    if (kingdom->divine_penalty_timer_days > 0) kingdom->divine_penalty_timer_days--;
+    if (kingdom->population > 0) kingdom->unrest_level += UNREST_GAIN_FROM_TAXES;
+
+    if (kingdom->unrest_level > DISSENT_THRESHOLD) {
+        int unrest_over_threshold = kingdom->unrest_level - DISSENT_THRESHOLD;
+        if (unrest_over_threshold > MAX_UNREST_FOR_REBEL_CONVERSION) unrest_over_threshold = MAX_UNREST_FOR_REBEL_CONVERSION;
+        double chance = (double)unrest_over_threshold / REBEL_CHANCE_DIVISOR;
+        int defections = draw_count(rng, world->soldiers, chance * SOLDIER_DEFECTION_CHANCE_MODIFIER);
+        if (defections > MAX_NEW_REBELS_PER_DAY) defections = MAX_NEW_REBELS_PER_DAY;
+        int turned = draw_count(rng, civilians(world), chance);
+        if (turned > MAX_NEW_REBELS_PER_DAY - defections) turned = MAX_NEW_REBELS_PER_DAY - defections;
+        take_civilians(world, turned);
+        world->soldiers -= defections;
+        world->rebels += turned + defections;
+        kingdom->army_morale -= 5 * defections;
+        if (kingdom->army_morale < 0) kingdom->army_morale = 0;
+    }
+
+    float tax_modifier = (kingdom->divine_penalty_timer_days > 0) ? kingdom->divine_tax_modifier : 1.0f;
+    kingdom->treasury += (long long)(kingdom->population * TAX_RATE_PER_PERSON * tax_modifier);
+
+    recruit(world, rng);
+    if (kingdom->food < AI_CRITICAL_FOOD_DAYS_THRESHOLD * (kingdom->population + 1)) {
+        kingdom->labor_goal = LABOR_GOAL_FAMINE;
+        shift_labor(world);
+    } else {
+        carry_out(world, governor_heuristic(kingdom, world->soldiers, world->rebels, NULL), rng);
+    }
+
+    if (kingdom->unrest_level >= REBELLION_THRESHOLD ||
+        (world->rebels > CIVIL_WAR_MINIMUM_REBELS && world->rebels > world->soldiers * CIVIL_WAR_REBEL_TO_SOLDIER_RATIO)) {
+        world->collapsed = true;
+    }
+}
+
+/**
+ * @brief How good a rollout's last day looks compared with where it started.
+ */
+static double judge(const struct PlanWorld *start, const struct PlanWorld *end)
+{
+    const struct Kingdom *kingdom = &end->kingdom;
+    double score = (double)kingdom->population / (start->kingdom.population + 1);
+    score -= (double)kingdom->unrest_level / REBELLION_THRESHOLD;
+
+    double rebels_per_soldier = (double)end->rebels / (end->soldiers + 1);
+    score -= PLAN_REBEL_WEIGHT * (rebels_per_soldier < 2.0 ? rebels_per_soldier : 2.0);
+
+    double food_days = kingdom->food / (kingdom->population + 1.0);
+    score += PLAN_FOOD_WEIGHT * (food_days < PLAN_FOOD_DAYS_GOAL ? food_days : PLAN_FOOD_DAYS_GOAL) / PLAN_FOOD_DAYS_GOAL;
+
+    double treasury = (double)kingdom->treasury / AI_DIVINE_INTERVENTION_TREASURY_THRESHOLD;
+    score += PLAN_TREASURY_WEIGHT * (treasury < 1.0 ? (treasury > 0.0 ? treasury : 0.0) : 1.0);
+
+    if (end->collapsed) score -= PLAN_COLLAPSE_PENALTY;
+    return score;
+}
+
+struct PlanRound {
+    const struct PlanWorld *start;
+    const bool *allowed;
+    uint64_t seed;
+    double scores[PLAN_TASKS];
+};
+
+/**
+ * @brief Task t plays candidate t / GOVERNOR_ROLLOUTS_PER_ROUND forward. Rollout r of every
+ * candidate draws the same random numbers, so the candidates are compared on the same luck.
+ */
+static void run_rollout(int task_index, void *context)
+{
+    struct PlanRound *round = context;
+    int action = task_index / GOVERNOR_ROLLOUTS_PER_ROUND;
+    if (!round->allowed[action]) return;
+
+    struct RngStream rng;
+    rng_seed(&rng, round->seed + (uint64_t)(task_index % GOVERNOR_ROLLOUTS_PER_ROUND));
+    struct PlanWorld world = *round->start;
+    carry_out(&world, action, &rng);
+    for (int day = 0; day < GOVERNOR_HORIZON_DAYS && !world.collapsed; day++) {
+        live_day(&world, &rng);
+        council_day(&world, &rng);
+    }
+    round->scores[task_index] = judge(round->start, &world);
+}
+
+/**
+ * @brief Runs rounds of rollouts for every action the kingdom can afford until the council's
+ * planning time or GOVERNOR_MAX_ROUNDS runs out. The first round always finishes.
+ */
+static int plan_with_rollouts(const struct Kingdom *kingdom, int soldier_count, int rebel_count)
+{
+    if (out_of_time()) return GOVERNOR_USE_HEURISTIC;
+
+    struct PlanWorld start = { .kingdom = *kingdom, .soldiers = soldier_count, .rebels = rebel_count };
+    update_population(&start);
+    bool allowed[GOVERNOR_ACTIONS] = { true, true, kingdom->treasury >= AI_FESTIVAL_COST, true };
+
+    // Seeded from the world's stream without drawing from it, so planning leaves it untouched
+    uint64_t seed = 14695981039346656037ULL;
+    for (int lane = 0; lane < RNG_LANES; lane++) seed = (seed ^ g_sim_rng.lanes[lane]) * 1099511628211ULL;
+    seed = (seed ^ (uint64_t)kingdom->id) * 1099511628211ULL;
+
+    struct PlanRound round = { .start = &start, .allowed = allowed };
+    double totals[GOVERNOR_ACTIONS] = { 0.0 };
+    for (int r = 0; r < GOVERNOR_MAX_ROUNDS && (r == 0 || !out_of_time()); r++) {
+        round.seed = seed + (uint64_t)r * GOVERNOR_ROLLOUTS_PER_ROUND;
+        workers_run(PLAN_TASKS, run_rollout, &round);
+        for (int t = 0; t < PLAN_TASKS; t++) {
+            if (allowed[t / GOVERNOR_ROLLOUTS_PER_ROUND]) totals[t / GOVERNOR_ROLLOUTS_PER_ROUND] += round.scores[t];
+        }
+    }
+
+    int best = GOVERNOR_HOLD;
+    for (int action = GOVERNOR_HOLD + 1; action < GOVERNOR_ACTIONS; action++) {
+        if (allowed[action] && totals[action] > totals[best]) best = action;
+    }
+    return best;
+}
+
+int governor_plan(const struct Kingdom *kingdom, int soldier_count, int rebel_count)
+{
+    int action;
+    if (journal_replayed_plan(kingdom->id, &action)) return action;
+    if (governor.budget_ms == 0) return GOVERNOR_USE_HEURISTIC;
+
+    action = plan_with_rollouts(kingdom, soldier_count, rebel_count);
+    journal_plan(kingdom->id, action);
+    return action;
+}
+
+const char *governor_action_name(int action)
+{
+    switch (action) {
+        case GOVERNOR_HOLD: return "save the treasury";
+        case GOVERNOR_RECRUIT: return "raise troops";
+        case GOVERNOR_FESTIVAL: return "host a festival";
+        case GOVERNOR_FEED: return "send workers to the farms";
+        default: return "follow the old counsel";
+    }
+}
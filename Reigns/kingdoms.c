@@ -6,42 +6,40 @@
 #include "../logger.h" // For logging events
 #include "../game_config.h"
 #include "../shared_data.h"
+#include "../workers.h"
+#include "../cohorts.h"
+#include "../governor.h"
 
 /**
  * @brief Creates a specified number of new humans and assigns them a job and kingdom.
- * This directly expands the main human array.
+ * This directly expands the main human array, or joins them to the cohorts in cohort mode.
  */
 void create_new_humans_as_job(int count, int job_id, int kingdom_id, struct Human_Data *data) {
     if (count <= 0) return;
-
-    // --- Safely reallocate memory if needed ---
-    int required_capacity = data->count + count;
-    if (required_capacity > data->capacity) {
-        int new_capacity = required_capacity * HUMAN_ARRAY_GROWTH_FACTOR;
-        void *temp_ptr = realloc(data->humans, new_capacity * sizeof(struct Human_Stats));
-        if (temp_ptr == NULL) {
-            fprintf(stderr, "Error: Failed to reallocate memory for divine reinforcements.\n");
-            return;
-        }
-        data->humans = temp_ptr;
-        data->capacity = new_capacity;
+    if (g_cohorts.enabled) {
+        cohort_add_members(kingdom_id, job_id, count, 100, 100);
+        return;
     }
 
-    // --- Create the new humans at the end of the array ---
-    int start_index = data->count;
-    for (int i = start_index; i < start_index + count; i++) {
-        struct Human_Stats human;
-        human.name = "Divine Recruit";
-        human.health = 100;
-        human.hunger = 100;
-        human.job = job_id;
-        human.is_general = 0; // Divine recruits are not leaders
-        human.bronze = STARTING_BRONZE;
-        human.alive = 1;
-        human.kingdom_id = kingdom_id;
-        data->humans[i] = human;
+    struct SpawnTemplate recruit = {
+        .name = "Divine Recruit", .health = 100, .hunger = 100, .stat_min = 1, .stat_range = 30,
+        .job = job_id, .is_general = 0, // Divine recruits are not leaders
+        .bronze = STARTING_BRONZE, .newborn = false
+    };
+    if (spawn_humans(data, &recruit, kingdom_id, count) < 0) {
+        fprintf(stderr, "Error: Failed to reallocate memory for divine reinforcements.\n");
     }
-    data->count += count; // Update the total count
+}
+
+/**
+ * @brief Delivers the divine reinforcements the governor prayed for today.
+ * This can grow the human array, so it never runs while kingdoms are being managed in parallel.
+ */
+static void deliver_divine_recruits(struct Kingdom *kingdom, struct Human_Data *data) {
+    if (kingdom->pending_divine_recruits <= 0) return;
+    create_new_humans_as_job(kingdom->pending_divine_recruits, JOB_SWORDSMAN, kingdom->id, data);
+    kingdom->population += kingdom->pending_divine_recruits;
+    kingdom->pending_divine_recruits = 0;
 }
 
 void recalculate_kingdom_populations(struct Kingdom kingdoms[], struct Human_Data *data) {
@@ -58,6 +56,11 @@ void recalculate_kingdom_populations(struct Kingdom kingdoms[], struct Human_Dat
             }
         }
     }
+    if (g_cohorts.enabled) {
+        for (int i = 0; i < NUM_KINGDOMS; i++) {
+            if (kingdoms[i].is_active) kingdoms[i].population += cohort_population(i);
+        }
+    }
 }
 
 /**
@@ -124,15 +127,23 @@ void initialize_world_polities(struct Kingdom kingdoms[]) {
         .story_production_modifier = 1.0,
         .story_food_daily_cap = 0
     };
+
+    // Every polity starts out with the peacetime division of labor
+    for (int i = 0; i < NUM_KINGDOMS; i++) {
+        plan_labor_shares(&kingdoms[i]);
+    }
 }
 
 /**
- * @brief SHARED LOGIC for daily management of any active kingdom.
- * This version has been REFACTORED to be highly efficient to prevent GUI freezes.
+ * @brief Kingdom-level work done before the daily pass over the citizens.
  */
-void manage_kingdom_daily(struct Kingdom *kingdom, struct Human_Data *data) {
+static void begin_kingdom_day(struct Kingdom *kingdom, struct KingdomDay *day) {
+    memset(day, 0, sizeof(*day));
     if (!kingdom->is_active) return;
 
+    // The pass may run on a worker, so it rolls from its own stream instead of rand()
+    rng_seed(&day->rng, ((uint64_t)rng_next(&g_sim_rng) << 32) | rng_next(&g_sim_rng));
+
     if (kingdom->divine_penalty_timer_days > 0) {
         kingdom->divine_penalty_timer_days--;
         if (kingdom->divine_penalty_timer_days == 0) {
@@ -144,31 +155,151 @@ void manage_kingdom_daily(struct Kingdom *kingdom, struct Human_Data *data) {
 
     kingdom->can_use_divine_intervention = true;
 
-    // --- Store "Before" State ---
-    int unrest_before = kingdom->unrest_level;
-    int pop_before = kingdom->population;
-    int food_before = kingdom->food;
-    int wood_before = kingdom->wood;
-    int stone_before = kingdom->stone;
-    int metal_before = kingdom->metal;
-
-    // --- Run Daily Logic ---
-    collect_taxes(kingdom, data);
-    update_kingdom_unrest(kingdom, data);
-    handle_recruitment_and_dissent(kingdom, data);
-    recruit_soldiers(kingdom, data);
-    EmpireAI(kingdom, data);
+    // The tax collectors go out before anyone decides whether to rebel
+    if (kingdom->population > 0) kingdom->unrest_level += UNREST_GAIN_FROM_TAXES;
+    update_kingdom_unrest(kingdom, NULL);
+    prepare_dissent(kingdom, day);
+}
+
+/**
+ * @brief The fused daily pass: taxes, dissent, recruitment candidacy and the military census.
+ * Every citizen in [begin, end) is visited once and booked against their own kingdom's day.
+ */
+static void run_daily_pass(struct KingdomDay days[], const bool managed[], struct Human_Data *data, int begin, int end) {
+    for (int i = begin; i < end; i++) {
+        struct Human_Stats *human = &data->humans[i];
+        if (human->alive != 1) continue;
+        int kingdom_id = human->kingdom_id;
+        if (kingdom_id < 0 || kingdom_id >= NUM_KINGDOMS || !managed[kingdom_id]) continue;
+        struct KingdomDay *day = &days[kingdom_id];
+
+        // Taxes
+        if (human->bronze >= TAX_RATE_PER_PERSON) {
+            human->bronze -= TAX_RATE_PER_PERSON;
+            day->taxes_collected += TAX_RATE_PER_PERSON;
+        }
+
+        // Dissent
+        if (day->dissent_active && human->job != JOB_REBEL && day->new_rebels < MAX_NEW_REBELS_PER_DAY) {
+            bool is_soldier = (human->job >= JOB_SWORDSMAN && human->job <= JOB_CAVALRY);
+            int chance = is_soldier ? day->soldier_defection_chance : day->civilian_rebel_chance;
+            if ((int)(rng_next(&day->rng) % REBEL_CHANCE_DIVISOR) < chance) {
+                if (is_soldier) day->defections++;
+                human->job = JOB_REBEL;
+                day->new_rebels++;
+                if (rng_next(&day->rng) % 100 < REBEL_LEADER_SPAWN_CHANCE_PERCENT) {
+                    human->is_general = 1;
+                }
+            }
+        }
+
+        // Census and candidate lists
+        day->population++;
+        if (human->job >= JOB_SWORDSMAN && human->job <= JOB_CAVALRY) {
+            day->soldier_count++;
+        } else if (human->job == JOB_REBEL) {
+            day->rebel_count++;
+        } else if (human->job >= 0 && human->job <= JOB_BLACKSMITH) {
+            int job = human->job;
+            day->job_census[job]++;
+            if (job > 0 && day->recruit_candidate_count < DAILY_RECRUIT_POOL) {
+                day->recruit_candidates[day->recruit_candidate_count++] = i;
+            }
+            if (day->labor_candidate_count[job] < LABOR_CANDIDATE_POOL) {
+                day->labor_candidates[job][day->labor_candidate_count[job]++] = i;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Kingdom-level decisions taken once the daily pass is over.
+ */
+static void finish_kingdom_day(struct Kingdom *kingdom, struct KingdomDay *day, struct Human_Data *data) {
+    if (!kingdom->is_active) return;
+
+    kingdom->population = day->population;
+    memcpy(kingdom->labor_force, day->job_census, sizeof(kingdom->labor_force));
+    collect_taxes(kingdom, day);
+
+    kingdom->army_morale -= 5 * day->defections;
+    if (kingdom->army_morale < 0) kingdom->army_morale = 0;
+
+    recruit_soldiers(kingdom, day, data);
+    EmpireAI(kingdom, day, data);
+
+    // The labor market follows the governor's orders
+    plan_labor_shares(kingdom);
+    rebalance_labor(kingdom, day, data);
 
     // Morale Management (This is a daily check)
     if (kingdom->food > kingdom->population * MORALE_FOOD_SURPLUS_MULTIPLIER && kingdom->army_morale < 100) { kingdom->army_morale += MORALE_GAIN_FROM_SURPLUS; }
     if (kingdom->unrest_level > DISSENT_THRESHOLD && kingdom->army_morale > MINIMUM_MORALE_FOR_UNREST_LOSS) { kingdom->army_morale -= MORALE_LOSS_FROM_UNREST; }
+}
+
+// Only touched from the simulation thread
+static struct KingdomDay council_days[NUM_KINGDOMS];
+
+struct DailyCouncil {
+    struct KingdomDay *days;
+    const bool *managed;
+    struct Human_Data *data;
+};
+
+static void run_council_pass(int task_index, void *context) {
+    struct DailyCouncil *council = context;
+    if (!council->managed[task_index]) return;
+    int begin, end;
+    kingdom_range(council->data, task_index, &begin, &end);
+    run_daily_pass(council->days, council->managed, council->data, begin, end);
+}
 
-    // After potential famine deaths, recount the population
-    recalculate_kingdom_populations(kingdom, data);
+/**
+ * @brief Runs the daily council for the active kingdoms in [first, last].
+ * The citizens are walked once in total. Once the population is sharded, each kingdom's pass
+ * runs on a worker thread over its own shard; before that one pass covers the whole array.
+ */
+static void run_daily_council(struct Kingdom kingdoms[], int first, int last, struct Human_Data *data) {
+    governor_begin_council();
+    bool managed[NUM_KINGDOMS] = { false };
+    for (int k = first; k <= last; k++) {
+        managed[k] = kingdoms[k].is_active;
+        begin_kingdom_day(&kingdoms[k], &council_days[k]);
+    }
+
+    struct DailyCouncil council = { council_days, managed, data };
+    if (data->is_sharded) {
+        workers_run(NUM_KINGDOMS, run_council_pass, &council);
+    } else {
+        run_daily_pass(council_days, managed, data, 0, data->count);
+    }
+    if (g_cohorts.enabled) cohort_daily_pass(council_days, managed);
 
+    for (int k = first; k <= last; k++) {
+        finish_kingdom_day(&kingdoms[k], &council_days[k], data);
+    }
 }
 
-// Add this new function to the bottom of kingdoms.c
+/**
+ * @brief SHARED LOGIC for daily management of any active kingdom.
+ * Runs the daily council for this kingdom alone.
+ */
+void manage_kingdom_daily(struct Kingdom *kingdom, struct Human_Data *data) {
+    if (!kingdom->is_active) return;
+
+    governor_begin_council();
+    bool managed[NUM_KINGDOMS] = { false };
+    managed[kingdom->id] = true;
+    struct KingdomDay *day = &council_days[kingdom->id];
+    begin_kingdom_day(kingdom, day);
+
+    int begin, end;
+    kingdom_range(data, kingdom->id, &begin, &end);
+    run_daily_pass(council_days, managed, data, begin, end);
+    if (g_cohorts.enabled) cohort_daily_pass(council_days, managed);
+
+    finish_kingdom_day(kingdom, day, data);
+}
 
 /**
  * @brief A more advanced AI governor for managing a kingdom.
@@ -176,22 +307,18 @@ void manage_kingdom_daily(struct Kingdom *kingdom, struct Human_Data *data) {
  * 1. CATASTROPHE AVERSION: Checks for immediate, game-ending threats (like starvation).
  * 2. REACTIVE MANAGEMENT: If no catastrophe, it identifies the most pressing current issue (unrest, weak military, low food) and addresses it.
  * 3. PROACTIVE MANAGEMENT: If the kingdom is stable, it works towards long-term goals, like building up the army to an ideal size.
+ * Steps 2 and 3 are the urgency heuristic of governor.h, which the planning governor can overrule.
  */
-void EmpireAI(struct Kingdom *kingdom, struct Human_Data *data) {
+void EmpireAI(struct Kingdom *kingdom, struct KingdomDay *day, struct Human_Data *data) {
     // --- 1. Intelligence Gathering Phase ---
     // Avoids action if the population is too small to matter.
+    kingdom->labor_goal = LABOR_GOAL_NONE;
     if (kingdom->population < 100) return;
 
     // Calculate key metrics
     int daily_food_consumption = kingdom->population + 1;
     float food_days_left = (daily_food_consumption > 0) ? (float)kingdom->food / daily_food_consumption : 999;
-    int soldier_count = 0, rebel_count = 0;
-    for (int i = 0; i < data->count; i++) {
-        if (data->humans[i].alive == 1 && data->humans[i].kingdom_id == kingdom->id) {
-            if (data->humans[i].job >= JOB_SWORDSMAN && data->humans[i].job <= JOB_CAVALRY) soldier_count++;
-            if (data->humans[i].job == JOB_REBEL) rebel_count++;
-        }
-    }
+    int soldier_count = day->soldier_count, rebel_count = day->rebel_count;
     
     float military_ratio = (float)soldier_count / (float)(rebel_count + 1);
     float food_urgency = (food_days_left < AI_FOOD_DAYS_THRESHOLD) ? 1.0f - (food_days_left / AI_FOOD_DAYS_THRESHOLD) : 0.0f;
@@ -205,7 +332,7 @@ void EmpireAI(struct Kingdom *kingdom, struct Human_Data *data) {
         if (military_urgency > 0.8f) {
             log_event("GOVERNOR AI: Our armies are collapsing! We pray for divine reinforcements!");
             kingdom->treasury -= DI_COST_REINFORCEMENTS;
-            create_new_humans_as_job(DI_REINFORCEMENTS_COUNT, JOB_SWORDSMAN, kingdom->id, data);
+            kingdom->pending_divine_recruits += DI_REINFORCEMENTS_COUNT; // They arrive once the council is over
             kingdom->divine_tax_modifier = DI_PENALTY_TAX_MODIFIER;
             kingdom->divine_penalty_timer_days = PENALTY_DURATION_DAYS;
             kingdom->can_use_divine_intervention = false; // Used its one miracle for the day
@@ -239,74 +366,81 @@ void EmpireAI(struct Kingdom *kingdom, struct Human_Data *data) {
     // If we are about to starve, this is the ONLY priority. Nothing else matters.
     if (food_days_left < AI_CRITICAL_FOOD_DAYS_THRESHOLD) {
         log_event("GOVERNOR: Reassigning all available");
-        int converted_workers = 0;
-        for (int i = 0; i < data->count && converted_workers < AI_FARMER_CONVERSION_COUNT; i++) {
-            if (data->humans[i].alive == 1 && data->humans[i].kingdom_id == kingdom->id) {
-                // Convert non-essential jobs to farmers
-                if (data->humans[i].job == JOB_LUMBERJACK || data->humans[i].job == JOB_MINER || data->humans[i].job == JOB_BLACKSMITH) {
-                    data->humans[i].job = JOB_FARMER;
-                    converted_workers++;
-                }
-            }
-        }
+        kingdom->labor_goal = LABOR_GOAL_FAMINE; // Non-essential workers go to the farms
         return; // Override all other logic
     }
 
-    // --- 3. Tier 2: Reactive Problem Solving ---
-    // Calculate urgency scores for major problems.
-
-    // Find the most urgent problem
-    float max_urgency = 0.0f;
-    if (food_urgency > max_urgency) max_urgency = food_urgency;
+    // --- 3. Tiers 2 and 3: Everyday Government ---
+    // The urgency heuristic answers the most pressing problem, or builds up the army when all is calm.
+    // Once something is brewing, the planning governor plays the options a week ahead and may overrule it.
+    const char *reason = NULL;
+    int action = governor_heuristic(kingdom, soldier_count, rebel_count, &reason);
+    float max_urgency = food_urgency;
     if (unrest_urgency > max_urgency) max_urgency = unrest_urgency;
     if (military_urgency > max_urgency) max_urgency = military_urgency;
-    
-    // Only act if the problem is significant enough to warrant a response.
-    if (max_urgency > AI_ACTION_THRESHOLD) {
-        if (military_urgency == max_urgency) {
-            log_event("GOVERNOR: Prioritizing recruitment.");
-            recruit_soldiers(kingdom, data);
-            return;
+    if (max_urgency > AI_STABILITY_ACTION_THRESHOLD) {
+        int planned = governor_plan(kingdom, soldier_count, rebel_count);
+        if (planned != GOVERNOR_USE_HEURISTIC && planned != action) {
+            log_event("GOVERNOR: Looking a week ahead, %s chooses to %s rather than %s.", kingdom->name,
+                      governor_action_name(planned), governor_action_name(action));
+            action = planned;
+            reason = NULL;
         }
-        if (unrest_urgency == max_urgency && kingdom->treasury >= AI_FESTIVAL_COST) {
-            log_event("GOVERNOR: Hosting festivals to calm the populace.");
+    }
+    if (reason != NULL) log_event("%s", reason);
+
+    switch (action) {
+        case GOVERNOR_RECRUIT:
+            recruit_soldiers(kingdom, day, data);
+            kingdom->labor_goal = LABOR_GOAL_ARM;
+            break;
+        case GOVERNOR_FESTIVAL:
             kingdom->treasury -= AI_FESTIVAL_COST;
             kingdom->unrest_level -= AI_FESTIVAL_UNREST_REDUCTION;
             if (kingdom->unrest_level < 0) kingdom->unrest_level = 0;
-            return;
-        }
-        if (food_urgency == max_urgency) {
-            log_event("GOVERNOR: Assigning more workers to farms.");
-            int converted_workers = 0;
-            for (int i = 0; i < data->count && converted_workers < AI_FARMER_CONVERSION_COUNT / 2; i++) { // Less drastic than the catastrophe response
-                if (data->humans[i].alive == 1 && data->humans[i].kingdom_id == kingdom->id && (data->humans[i].job == JOB_LUMBERJACK || data->humans[i].job == JOB_MINER)) {
-                    data->humans[i].job = JOB_FARMER;
-                    converted_workers++;
-                }
-            }
-            return;
-        }
-    }
-
-    // --- 4. Tier 3: Proactive Management ---
-    // If there are no immediate crises, the AI works on long-term stability.
-    // Its primary goal is to maintain a standing army relative to its population.
-    float ideal_army_size = kingdom->population * AI_ARMY_SIZE_GOAL_PERCENT;
-    if (soldier_count < ideal_army_size) {
-        log_event("GOVERNOR: The kingdom is stable.");
-        recruit_soldiers(kingdom, data); // Recruit slowly to reach the ideal size
-    } else {
-        // If all goals are met, the AI does nothing and saves resources.
-        // You could add a log_event here for debugging if you want.
-        // log_event("GOVERNOR AI: The kingdom is stable and well-defended. Conserving resources.");
+            break;
+        case GOVERNOR_FEED:
+            kingdom->labor_goal = LABOR_GOAL_FEED; // Less drastic than the catastrophe response
+            break;
+        default:
+            // If all goals are met, the AI does nothing and saves resources.
+            break;
     }
 }
 
 // --- Unique Kingdom Entry Points ---
 
+/**
+ * @brief Promotes the cohort rebels who rose to lead today's dissent to notable leaders.
+ * Like the divine recruits, this can grow the array, so it waits until the council is over.
+ */
+static void promote_new_leaders(struct Kingdom *kingdom, struct Human_Data *data) {
+    struct KingdomDay *day = &council_days[kingdom->id];
+    if (!g_cohorts.enabled || day->new_leaders <= 0) return;
+    int promoted = cohort_promote(data, kingdom->id, JOB_REBEL, day->new_leaders);
+    if (promoted > 0) log_event("%d new rebel leaders rise in %s.", promoted, kingdom->name);
+    day->new_leaders = 0;
+}
+
 void manage_empire(struct Kingdom *self, struct Human_Data *data) {
     if (!self->is_active) return;
     manage_kingdom_daily(self, data);
+    deliver_divine_recruits(self, data);
+    promote_new_leaders(self, data);
+}
+
+/**
+ * @brief Daily management of the seven successor kingdoms.
+ * Each kingdom's pass only touches its own shard, so the passes run concurrently on the
+ * worker threads. Anything that can grow the array happens afterwards.
+ */
+void manage_successor_kingdoms_daily(struct Kingdom kingdoms[], struct Human_Data *data) {
+    run_daily_council(kingdoms, 1, NUM_KINGDOMS - 1, data);
+
+    for (int i = 1; i < NUM_KINGDOMS; i++) {
+        deliver_divine_recruits(&kingdoms[i], data);
+        promote_new_leaders(&kingdoms[i], data);
+    }
 }
 
 void EstherKingdom(struct Kingdom *self, struct Human_Data *data) {
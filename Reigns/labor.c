@@ -0,0 +1,161 @@
+// file: labor.c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "../humans.h"
+#include "../game_config.h"
+#include "../cohorts.h"
+
+/**
+ * @brief Works out which share of a kingdom's civilian workforce each job should have.
+ * Starts from the peacetime split, then shifts it towards the mines and forests while the
+ * governor is arming, away from idle forges when metal is short, and towards the farms as
+ * the food runs low.
+ */
+void plan_labor_shares(struct Kingdom *kingdom)
+{
+    int share[JOB_BLACKSMITH + 1] = {
+        [JOB_FARMER] = LABOR_SHARE_FARMER,
+        [JOB_BUTCHER] = LABOR_SHARE_BUTCHER,
+        [JOB_LUMBERJACK] = LABOR_SHARE_LUMBERJACK,
+        [JOB_MINER] = LABOR_SHARE_MINER,
+        [JOB_BLACKSMITH] = LABOR_SHARE_BLACKSMITH,
+    };
+
+    // Recruits cost metal and wood
+    if (kingdom->labor_goal == LABOR_GOAL_ARM) {
+        share[JOB_MINER] += LABOR_ARMING_SHIFT;
+        share[JOB_LUMBERJACK] += LABOR_ARMING_SHIFT;
+        share[JOB_FARMER] -= 2 * LABOR_ARMING_SHIFT;
+    }
+
+    // Forges without metal stand idle, so half of them go down the mines
+    int blacksmiths = kingdom->labor_force[JOB_BLACKSMITH] > 0 ? kingdom->labor_force[JOB_BLACKSMITH] : 1;
+    if (kingdom->metal < blacksmiths * BLACKSMITH_METAL_NEEDS) {
+        int moved = share[JOB_BLACKSMITH] / 2;
+        share[JOB_BLACKSMITH] -= moved;
+        share[JOB_MINER] += moved;
+    }
+
+    // Food urgency (0.0 - 1.0) from the days of food left, raised by the governor's orders
+    float food_days_left = (float)kingdom->food / (float)(kingdom->population + 1);
+    float urgency = (food_days_left < AI_FOOD_DAYS_THRESHOLD) ? 1.0f - (food_days_left / AI_FOOD_DAYS_THRESHOLD) : 0.0f;
+    if (kingdom->labor_goal == LABOR_GOAL_FEED && urgency < 0.5f) urgency = 0.5f;
+    if (kingdom->labor_goal == LABOR_GOAL_FAMINE) urgency = 1.0f;
+
+    if (urgency > 0.0f) {
+        int farmer_share = share[JOB_FARMER] + (int)(urgency * (LABOR_MAX_FARMER_SHARE - share[JOB_FARMER]));
+        int others = 1000 - share[JOB_FARMER];
+        int assigned = 0;
+        for (int j = JOB_BUTCHER; j <= JOB_BLACKSMITH; j++) {
+            share[j] = (others > 0) ? share[j] * (1000 - farmer_share) / others : 0;
+            assigned += share[j];
+        }
+        share[JOB_FARMER] = 1000 - assigned; // Rounding leftovers go to the farms
+    }
+
+    memcpy(kingdom->labor_share, share, sizeof(share));
+}
+
+/**
+ * @brief Picks the job a newly employed citizen of this kingdom takes: the one furthest
+ * below its share. Only civilian jobs are handed out; soldiers are recruited and paid for.
+ */
+int choose_job_for_hire(struct Kingdom *kingdom)
+{
+    int *force = kingdom->labor_force;
+    int total = 1; // The newcomer
+    for (int j = 0; j <= JOB_BLACKSMITH; j++) total += force[j];
+
+    int best_job = JOB_FARMER;
+    long long best_gap = LLONG_MIN;
+    for (int j = JOB_FARMER; j <= JOB_BLACKSMITH; j++) {
+        long long gap = (long long)kingdom->labor_share[j] * total / 1000 - force[j];
+        if (gap > best_gap) {
+            best_gap = gap;
+            best_job = j;
+        }
+    }
+
+    if (force[0] > 0) force[0]--;
+    force[best_job]++;
+    return best_job;
+}
+
+/**
+ * @brief Takes the next of today's candidates who still works `job`, or returns -1.
+ */
+static int take_labor_candidate(struct KingdomDay *day, struct Human_Data *data, int job, int next[])
+{
+    while (next[job] < day->labor_candidate_count[job]) {
+        int i = day->labor_candidates[job][next[job]++];
+        if (data->humans[i].alive == 1 && data->humans[i].job == job) return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Moves the fewest citizens needed to bring every job back to its share.
+ * The unemployed are placed first, then the jobs with the largest surplus give up workers.
+ * Works from the candidate lists of the daily pass, so the cost is one step per move.
+ */
+void rebalance_labor(struct Kingdom *kingdom, struct KingdomDay *day, struct Human_Data *data)
+{
+    int *force = kingdom->labor_force;
+    int total = 0;
+    for (int j = 0; j <= JOB_BLACKSMITH; j++) total += force[j];
+    if (total == 0) return;
+
+    // Positive gap: workers missing. Negative gap: workers to spare.
+    int gap[JOB_BLACKSMITH + 1];
+    gap[0] = -force[0];
+    for (int j = JOB_FARMER; j <= JOB_BLACKSMITH; j++) {
+        int target = (int)((long long)kingdom->labor_share[j] * total / 1000);
+        int tolerance = target * LABOR_TOLERANCE_PERCENT / 100;
+        if (tolerance < 1) tolerance = 1;
+        gap[j] = target - force[j];
+        if (abs(gap[j]) <= tolerance) gap[j] = 0;
+    }
+
+    int next[JOB_BLACKSMITH + 1] = {0};
+    while (1) {
+        // The job missing the most workers...
+        int to = -1;
+        for (int j = JOB_FARMER; j <= JOB_BLACKSMITH; j++) {
+            if (gap[j] > 0 && (to < 0 || gap[j] > gap[to])) to = j;
+        }
+        if (to < 0) break;
+
+        // ...is filled from the unemployed, then from the job with the most to spare
+        int from = -1;
+        if (gap[0] < 0) {
+            from = 0;
+        } else {
+            for (int j = JOB_FARMER; j <= JOB_BLACKSMITH; j++) {
+                if (gap[j] < 0 && (from < 0 || gap[j] < gap[from])) from = j;
+            }
+        }
+        if (from < 0) break;
+
+        int i = take_labor_candidate(day, data, from, next);
+        if (i < 0) {
+            // No one left on today's list: the cohorts move in bulk
+            int wanted = (gap[to] < -gap[from]) ? gap[to] : -gap[from];
+            int moved = g_cohorts.enabled ? cohort_move_jobs(kingdom->id, from, to, wanted) : 0;
+            force[from] -= moved;
+            force[to] += moved;
+            gap[from] += moved;
+            gap[to] -= moved;
+            if (moved < wanted) gap[from] = 0;
+            continue;
+        }
+
+        data->humans[i].job = to;
+        force[from]--;
+        force[to]++;
+        gap[from]++;
+        gap[to]--;
+    }
+}
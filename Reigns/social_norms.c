@@ -2,83 +2,176 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
 #include "../market.h"
 #include "../humans.h"
 #include "../logger.h"
 #include "../game_config.h"
+#include "../rng.h"
+#include "../cohorts.h"
+#include "../workers.h"
+#include "../lifecycle.h"
 
 
+// --- Job Profiles ---
+// Everything a job does during a shift and on payday, taken from game_config.h.
+// The daily work shift and its wages look jobs up here instead of switching on them.
+enum { RES_NONE, RES_FOOD, RES_WOOD, RES_STONE, RES_METAL, RES_COUNT };
+
+#define JOB_KERNEL_BLOCK 256 // Humans handled per bulk draw of random numbers
+
+struct JobProfile {
+    int health_cost;          // Health lost by one shift
+    int hunger_cost;          // Hunger lost by one shift
+    int resource;             // RES_* produced by one shift: output_min + rand() % output_range
+    int output_min;
+    int output_range;
+    int alt_resource;         // Produced instead with alt_chance_percent (miners striking metal)
+    int alt_chance_percent;
+    int alt_min;
+    int alt_range;
+    int metal_needed;         // Metal consumed per shift. Without it only idle_hunger_cost applies.
+    int idle_hunger_cost;
+    int wage_min;             // Payday wage: wage_min + rand() % wage_range
+    int wage_range;
+};
+
+static const struct JobProfile job_profiles[JOB_REBEL + 1] = {
+    [0]              = {0}, // Unemployed
+    [JOB_FARMER]     = {FARMER_HEALTH_COST, FARMER_HUNGER_COST, RES_FOOD, 0, FARMER_FOOD_PRODUCTION,
+                        .wage_min = FARMER_WAGE_MIN, .wage_range = FARMER_WAGE_RANGE},
+    [JOB_BUTCHER]    = {BUTCHER_HEALTH_COST, BUTCHER_HUNGER_COST, RES_FOOD, 0, BUTCHER_MEAT_PRODUCTION,
+                        .wage_min = BUTCHER_WAGE_MIN, .wage_range = BUTCHER_WAGE_RANGE},
+    [JOB_LUMBERJACK] = {LUMBERJACK_HEALTH_COST, LUMBERJACK_HUNGER_COST, RES_WOOD, 1, LUMBERJACK_WOOD_PRODUCTION,
+                        .wage_min = LUMBERJACK_WAGE_MIN, .wage_range = LUMBERJACK_WAGE_RANGE},
+    [JOB_MINER]      = {MINER_HEALTH_COST, MINER_HUNGER_COST, RES_STONE, 1, MINER_STONE_PRODUCTION,
+                        RES_METAL, MINER_METAL_CHANCE_PERCENT, 1, MINER_METAL_PRODUCTION,
+                        .wage_min = MINER_WAGE_MIN, .wage_range = MINER_WAGE_RANGE},
+    [JOB_BLACKSMITH] = {BLACKSMITH_HEALTH_COST, BLACKSMITH_HUNGER_COST,
+                        .metal_needed = BLACKSMITH_METAL_NEEDS, .idle_hunger_cost = BLACKSMITH_IDLE_HUNGER_COST,
+                        .wage_min = BLACKSMITH_WAGE_MIN, .wage_range = BLACKSMITH_WAGE_RANGE},
+    [JOB_SWORDSMAN]  = {SOLDIER_HEALTH_COST, SOLDIER_HUNGER_COST, .wage_min = SOLDIER_WAGE_MIN, .wage_range = SOLDIER_WAGE_RANGE},
+    [JOB_ARCHER]     = {SOLDIER_HEALTH_COST, SOLDIER_HUNGER_COST, .wage_min = SOLDIER_WAGE_MIN, .wage_range = SOLDIER_WAGE_RANGE},
+    [JOB_CAVALRY]    = {SOLDIER_HEALTH_COST, SOLDIER_HUNGER_COST, .wage_min = SOLDIER_WAGE_MIN, .wage_range = SOLDIER_WAGE_RANGE},
+    [JOB_REBEL]      = {0}, // Rebels don't work and don't get paid
+};
+
 // --- Handles military recruitment and its costs ---
-void recruit_soldiers(struct Kingdom *kingdom, struct Human_Data *data) {
-    if (!kingdom->is_active || kingdom->population == 0) return;
+// Works through the civilians the daily pass put forward and returns how many took up arms.
+int recruit_soldiers(struct Kingdom *kingdom, struct KingdomDay *day, struct Human_Data *data) {
+    if (!kingdom->is_active || kingdom->population == 0) return 0;
 
     // Only recruit if unrest is moderate, as a show of force.
-    if (kingdom->unrest_level < DISSENT_THRESHOLD / 2) return;
+    if (kingdom->unrest_level < DISSENT_THRESHOLD / 2) return 0;
 
     // Try to recruit a small number of troops each day
     int recruits_wanted = 5 + (kingdom->unrest_level / 20);
     int recruited_count = 0;
 
-    for (int i = 0; i < data->count && recruited_count < recruits_wanted; i++) {
-        if (data->humans[i].alive == 1 && data->humans[i].kingdom_id == kingdom->id &&
-            data->humans[i].job > 0 && data->humans[i].job <= JOB_BLACKSMITH) {
-            int unit_choice = rand() % 3;
-            if (unit_choice == 0 && kingdom->metal >= COST_SWORDSMAN_METAL) {
-                kingdom->metal -= COST_SWORDSMAN_METAL;
-                data->humans[i].job = JOB_SWORDSMAN;
-                recruited_count++;
-            } else if (unit_choice == 1 && kingdom->wood >= COST_ARCHER_WOOD) {
-                kingdom->wood -= COST_ARCHER_WOOD;
-                data->humans[i].job = JOB_ARCHER;
-                recruited_count++;
-            } else if (unit_choice == 2 && kingdom->metal >= COST_CAVALRY_METAL && kingdom->food >= COST_CAVALRY_FOOD) {
-                kingdom->metal -= COST_CAVALRY_METAL;
-                kingdom->food -= COST_CAVALRY_FOOD;
-                data->humans[i].job = JOB_CAVALRY;
-                recruited_count++;
-            }
+    while (day->next_recruit_candidate < day->recruit_candidate_count && recruited_count < recruits_wanted) {
+        struct Human_Stats *human = &data->humans[day->recruit_candidates[day->next_recruit_candidate++]];
+        if (human->alive != 1 || human->job <= 0 || human->job > JOB_BLACKSMITH) continue;
+        int old_job = human->job;
+
+        int unit_choice = rand() % 3;
+        if (unit_choice == 0 && kingdom->metal >= COST_SWORDSMAN_METAL) {
+            kingdom->metal -= COST_SWORDSMAN_METAL;
+            human->job = JOB_SWORDSMAN;
+            recruited_count++;
+        } else if (unit_choice == 1 && kingdom->wood >= COST_ARCHER_WOOD) {
+            kingdom->wood -= COST_ARCHER_WOOD;
+            human->job = JOB_ARCHER;
+            recruited_count++;
+        } else if (unit_choice == 2 && kingdom->metal >= COST_CAVALRY_METAL && kingdom->food >= COST_CAVALRY_FOOD) {
+            kingdom->metal -= COST_CAVALRY_METAL;
+            kingdom->food -= COST_CAVALRY_FOOD;
+            human->job = JOB_CAVALRY;
+            recruited_count++;
         }
+        if (human->job != old_job) kingdom->labor_force[old_job]--;
     }
+
+    // The cohorts answer the call once today's candidates are used up
+    for (int attempt = 0; g_cohorts.enabled && recruited_count < recruits_wanted && attempt < DAILY_RECRUIT_POOL; attempt++) {
+        int old_job = cohort_pick_civilian_job(kingdom->id);
+        if (old_job < 0) break;
+
+        int unit_choice = rand() % 3;
+        int new_job = 0;
+        if (unit_choice == 0 && kingdom->metal >= COST_SWORDSMAN_METAL) {
+            kingdom->metal -= COST_SWORDSMAN_METAL;
+            new_job = JOB_SWORDSMAN;
+        } else if (unit_choice == 1 && kingdom->wood >= COST_ARCHER_WOOD) {
+            kingdom->wood -= COST_ARCHER_WOOD;
+            new_job = JOB_ARCHER;
+        } else if (unit_choice == 2 && kingdom->metal >= COST_CAVALRY_METAL && kingdom->food >= COST_CAVALRY_FOOD) {
+            kingdom->metal -= COST_CAVALRY_METAL;
+            kingdom->food -= COST_CAVALRY_FOOD;
+            new_job = JOB_CAVALRY;
+        }
+        if (new_job == 0) continue;
+
+        cohort_move_jobs(kingdom->id, old_job, new_job, 1);
+        kingdom->labor_force[old_job]--;
+        recruited_count++;
+    }
+    day->soldier_count += recruited_count;
+    return recruited_count;
 }
 
 /**
- * @brief Collects taxes from the population, increasing kingdom treasury and citizen unrest.
+ * @brief Pays the taxes gathered by the daily pass into the treasury.
+ * The unrest the collectors cause is added before the pass, so today's dissent already feels it.
  */
-void collect_taxes(struct Kingdom *kingdom, struct Human_Data *data)
+void collect_taxes(struct Kingdom *kingdom, const struct KingdomDay *day)
 {
     if (!kingdom->is_active || kingdom->population == 0) return;
-    int total_tax_collected = 0;
+    int total_tax_collected = day->taxes_collected;
 
-    for (int i = 0; i < data->count; i++) {
-        if (data->humans[i].alive == 1 && data->humans[i].kingdom_id == kingdom->id) {
-            if (data->humans[i].bronze >= TAX_RATE_PER_PERSON) {
-                data->humans[i].bronze -= TAX_RATE_PER_PERSON;
-                total_tax_collected += TAX_RATE_PER_PERSON;
-            }
-        }
-    }
     if (kingdom->divine_penalty_timer_days > 0) {
         total_tax_collected = (int)(total_tax_collected * kingdom->divine_tax_modifier);
     }
     kingdom->treasury += total_tax_collected;
-    kingdom->unrest_level += UNREST_GAIN_FROM_TAXES;
 }
 
 /**
- * @brief Assigns jobs to the entire initial population to ensure a stable start.
- * This version creates a standing army from the outset.
+ * @brief The first job roll, split into chunks for the worker pool. Every chunk rolls with
+ * its own random stream and remembers its first few would-be generals; merging those in
+ * chunk order picks the same generals however many workers there are.
  */
-void initial_job_assignment(struct Human_Data *data) {
+struct InitialJobs {
+    struct Human_Data *data;
+    uint64_t seed;
+    int (*general_candidates)[INITIAL_GENERAL_LIMIT];   // First would-be generals of each chunk
+    int *general_candidate_count;
+};
+
+static void assign_initial_jobs_chunk(int chunk, void *context) {
+    struct InitialJobs *jobs = context;
+    struct Human_Data *data = jobs->data;
     const int archer_pct = 5;
     const int cavalry_pct = 5;
     const int swordsman_pct = 5;
     const int blacksmith_pct = 10;
     const int miner_pct = 10;
     const int lumberjack_pct = 15;
-    int general_count = 0;
-    for (int i = 0; i < data->count; i++) {
-        if (data->humans[i].alive == 1) {
-            int job_roll = rand() % 100;
+    int begin = chunk * SPAWN_CHUNK;
+    int end = begin + SPAWN_CHUNK;
+    if (end > data->count) end = data->count;
+
+    struct RngStream rng;
+    rng_seed(&rng, jobs->seed + (uint64_t)chunk);
+    int candidates = 0;
+
+    uint32_t rolls[2 * JOB_KERNEL_BLOCK];
+    for (int block_start = begin; block_start < end; block_start += JOB_KERNEL_BLOCK) {
+        int block = (end - block_start < JOB_KERNEL_BLOCK) ? end - block_start : JOB_KERNEL_BLOCK;
+        rng_fill(&rng, rolls, 2 * block);
+        for (int n = 0; n < block; n++) {
+            int i = block_start + n;
+            if (data->humans[i].alive != 1) continue;
+            int job_roll = rolls[2 * n] % 100;
 
             if (job_roll < archer_pct) { // 5% Archers
                 data->humans[i].job = JOB_ARCHER;
@@ -86,9 +179,8 @@ void initial_job_assignment(struct Human_Data *data) {
                 data->humans[i].job = JOB_CAVALRY;
             } else if ((job_roll < cavalry_pct+archer_pct+swordsman_pct)){ // 5% Swordsmen
                 data->humans[i].job = JOB_SWORDSMAN;
-                if (general_count < INITIAL_GENERAL_LIMIT && (rand() % 100 < GENERAL_SPAWN_CHANCE_PERCENT)) {
-                    data->humans[i].is_general = 1;
-                    general_count++;
+                if (candidates < INITIAL_GENERAL_LIMIT && (rolls[2 * n + 1] % 100 < GENERAL_SPAWN_CHANCE_PERCENT)) {
+                    jobs->general_candidates[chunk][candidates++] = i;
                 }
             } else if (job_roll < blacksmith_pct) { // 10% Blacksmiths
                 data->humans[i].job = JOB_BLACKSMITH;
@@ -101,25 +193,56 @@ void initial_job_assignment(struct Human_Data *data) {
             }
         }
     }
+    jobs->general_candidate_count[chunk] = candidates;
+}
+
+/**
+ * @brief Assigns jobs to the entire initial population to ensure a stable start.
+ * This version creates a standing army from the outset.
+ */
+void initial_job_assignment(struct Human_Data *data) {
+    int chunk_count = (data->count + SPAWN_CHUNK - 1) / SPAWN_CHUNK;
+    struct InitialJobs jobs = { data, 0, NULL, NULL };
+    jobs.seed = ((uint64_t)rng_next(&g_sim_rng) << 32) | rng_next(&g_sim_rng);
+    jobs.general_candidates = malloc((chunk_count > 0 ? chunk_count : 1) * sizeof(*jobs.general_candidates));
+    jobs.general_candidate_count = malloc((chunk_count > 0 ? chunk_count : 1) * sizeof(int));
+    if (jobs.general_candidates == NULL || jobs.general_candidate_count == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for the initial job assignment.\n");
+        free(jobs.general_candidates);
+        free(jobs.general_candidate_count);
+        return;
+    }
+
+    workers_run(chunk_count, assign_initial_jobs_chunk, &jobs);
+
+    // The first would-be generals in population order get the commissions
+    int general_count = 0;
+    for (int c = 0; c < chunk_count; c++) {
+        for (int n = 0; n < jobs.general_candidate_count[c] && general_count < INITIAL_GENERAL_LIMIT; n++) {
+            data->humans[jobs.general_candidates[c][n]].is_general = 1;
+            general_count++;
+        }
+    }
+    free(jobs.general_candidates);
+    free(jobs.general_candidate_count);
     printf("Initial job assignments complete. The empire's army, workforce, and %d generals are ready!\n", general_count);
 }
 
 /**
  * @brief Assigns a job to any living human who is currently unemployed.
- * This function iterates through the entire population and gives jobs to anyone
- * with job ID 0, ensuring the workforce is replenished as new people are born.
+ * Each newcomer takes the civilian job their kingdom is shortest of (see labor.c),
+ * ensuring the workforce is replenished as new people are born.
  */
-void occupation(struct HumanPopulation *world_stat, struct Human_Data *data)
+void occupation(struct Kingdom kingdoms[], struct Human_Data *data)
 {
-    // Loop through every single human in the world.
     for (int i = 0; i < data->count; i++)
     {
         // Find people who are alive but have no job.
         if (data->humans[i].alive == 1 && data->humans[i].job == 0)
         {
-            // Assign them a random civilian job.
-            // (1) Farmer, (2) Butcher, (3) Lumberjack, (4) Miner, (5) Blacksmith
-            data->humans[i].job = (rand() % 8) + 1;
+            int k = data->humans[i].kingdom_id;
+            if (k < 0 || k >= NUM_KINGDOMS) continue;
+            data->humans[i].job = choose_job_for_hire(&kingdoms[k]);
         }
     }
 }
@@ -130,29 +253,6 @@ void commerce(struct Human_Data *data, int i)
     data->humans[i].bronze -= 15;
 }
 
-void payments(struct HumanPopulation *world_stat, struct Human_Data *data)
-{
-    // --- Iterate over actual data count, not world population estimate ---
-    for (int i = 0; i < data->count; i++)
-    {
-        if (data->humans[i].alive == 1)
-        {
-            switch (data->humans[i].job) {
-                case 1: data->humans[i].bronze += (rand() % 30) + 1; break; // Farmer
-                case 2: data->humans[i].bronze += (rand() % 50) + 1; break; // Butcher
-                case 3: data->humans[i].bronze += (rand() % 40) + 1; break; // Lumberjack
-                case 4: data->humans[i].bronze += (rand() % 30) + 1; break; // Miner
-                case 5: data->humans[i].bronze += (rand() % 85) + 1; break; // Blacksmith
-                case 6:
-                case 7:
-                case 8: data->humans[i].bronze += (rand() % 41) + 20; break; // Military
-                case 9: break; // Rebel
-            }
-        }
-    }
-}
-
-
 /**
  * @brief Calculates daily resource production and consumption for a kingdom.
  * This version includes higher food consumption for military units.
@@ -175,128 +275,421 @@ void apply_production_effects(struct Kingdom *kingdom) {
     }
 }
 
-void consume_resources(struct Kingdom *kingdom, struct Human_Data *data, int i){
-    // --- 2. Consumption Phase ---
-    // Civilians eat 2 food. Military members eat 2 + an extra amount.
-    
-    if (kingdom->food > 1) {
+// --- Food rationing ---
+// Food is handed out in three phases so that the order of humans[] no longer decides who eats:
+// 1. Every hungry citizen who can pay places a request (demand per kingdom and per job).
+// 2. Each kingdom works out which share of the requests its granary can serve.
+// 3. Every citizen eats their share. Only the citizen's own record is written.
+struct FoodRationPlan {
+    int demand[NUM_KINGDOMS][JOB_REBEL + 1]; // Food requested, per kingdom and per job
+    float ration[NUM_KINGDOMS];              // Share of each request that is served (0.0 - 1.0)
+    bool famine[NUM_KINGDOMS];               // The granary was empty before anyone ate
+};
 
-        // People need to eat to heal themselves
-        if (data->humans[i].hunger <= EAT_HUNGER_THRESHOLD) {
-            if (data->humans[i].bronze >= FOOD_COST){
-                data->humans[i].bronze -= FOOD_COST;
-                kingdom->food -= 2;
-                if (data->humans[i].job > 6 && data->humans[i].job < 9) kingdom->food -= MILITARY_EXTRA_FOOD_CONSUMPTION;
-                data->humans[i].hunger += (rand() % 40)+10;
-            } else {
-                data->humans[i].health -= 5;
-            }
+/**
+ * @brief Food eaten by one meal. Civilians eat 2 food, military members eat 2 + an extra amount.
+ */
+static int food_ration_size(int job)
+{
+    if (job >= JOB_SWORDSMAN && job <= JOB_CAVALRY) return 2 + MILITARY_EXTRA_FOOD_CONSUMPTION;
+    return 2;
+}
+
+static bool wants_to_eat(const struct Human_Stats *human)
+{
+    return human->alive == 1 && human->job != JOB_REBEL &&
+           human->hunger <= EAT_HUNGER_THRESHOLD && human->bronze >= FOOD_COST;
+}
+
+/**
+ * @brief Phases 1 and 2: gathers the food requests of this hour's workers and fixes the ration
+ * of every kingdom. The served food is taken out of the granary here, once per kingdom.
+ */
+static void plan_food_rations(struct FoodRationPlan *plan, struct Kingdom kingdoms[], struct Human_Data *data,
+                              const int *members, int member_count)
+{
+    memset(plan, 0, sizeof(*plan));
+
+    // --- Phase 1: Demand ---
+    for (int m = 0; m < member_count; m++) {
+        const struct Human_Stats *human = &data->humans[members[m]];
+        if (!wants_to_eat(human)) continue;
+        if (human->kingdom_id < 0 || human->kingdom_id >= NUM_KINGDOMS || human->job < 0 || human->job > JOB_REBEL) continue;
+        plan->demand[human->kingdom_id][human->job] += food_ration_size(human->job);
+    }
+
+    // --- Phase 2: Allocation ---
+    for (int k = 0; k < NUM_KINGDOMS; k++) {
+        if (kingdoms[k].food <= 1) {
+            plan->famine[k] = true;
+            continue;
         }
-        //if (kingdom->unrest_level > WELL_FED_UNREST_REDUCTION_AMOUNT) kingdom->unrest_level -= WELL_FED_UNREST_REDUCTION_AMOUNT; // Well-fed people are happier
-        // this will cause unrest to never increase. keep it commented for now.
-    } else {
-        log_event("!!! FAMINE in %s !!!", kingdom->name);
-        kingdom->food = 0;
-        kingdom->unrest_level += UNREST_GAIN_FROM_FAMINE;
-        int deaths_from_starvation = (int)(kingdom->population * (FAMINE_POPULATION_LOSS_PERCENT / 100.0f));
-        if (deaths_from_starvation < 1 && kingdom->population > 0) deaths_from_starvation = 1;
-
-        log_event(" -> %d people have died from starvation!", deaths_from_starvation);
-        
-        // --- STARVATION LOOP ---
-        if (data->humans[i].alive == 1 && data->humans[i].kingdom_id == kingdom->id && data->humans[i].hunger > 0) {
-            data->humans[i].hunger -= 10;
-        } else if (data->humans[i].hunger < 0){
-            data->humans[i].alive = 0;
+
+        int total_demand = 0;
+        for (int j = 0; j <= JOB_REBEL; j++) total_demand += plan->demand[k][j];
+        if (total_demand == 0) continue;
+
+        if (kingdoms[k].food >= total_demand) {
+            plan->ration[k] = 1.0f;
+            kingdoms[k].food -= total_demand;
+        } else {
+            // Not enough for everyone: every request gets the same share of what is left.
+            plan->ration[k] = (float)kingdoms[k].food / (float)total_demand;
+            kingdoms[k].food = 0;
         }
+    }
+}
+
+/**
+ * @brief Phase 3: one citizen eats the share of a meal their kingdom could serve.
+ * The meal is rolled from the slice's own stream.
+ */
+static void consume_resources(const struct FoodRationPlan *plan, struct Human_Data *data, int i, struct RngStream *rng)
+{
+    struct Human_Stats *human = &data->humans[i];
+    int k = human->kingdom_id;
+    if (k < 0 || k >= NUM_KINGDOMS) return;
+
+    if (plan->famine[k]) {
+        // Famine: the kingdom-wide effects are resolved once per hour by update_kingdom_famine.
+        if (human->hunger > 0) {
+            human->hunger -= FAMINE_HOURLY_HUNGER_LOSS;
+        }
+        return;
+    }
+
+    // People need to eat to heal themselves
+    if (human->hunger <= EAT_HUNGER_THRESHOLD) {
+        if (human->bronze >= FOOD_COST) {
+            float ration = plan->ration[k];
+            human->bronze -= (int)(FOOD_COST * ration + 0.5f); // A partial meal costs a partial price
+            human->hunger += (int)(((int)(rng_next(rng) % 40) + 10) * ration);
+        } else {
+            human->health -= 5;
         }
+    }
+    //if (kingdom->unrest_level > WELL_FED_UNREST_REDUCTION_AMOUNT) kingdom->unrest_level -= WELL_FED_UNREST_REDUCTION_AMOUNT; // Well-fed people are happier
+    // this will cause unrest to never increase. keep it commented for now.
 }
 
-void dailyneed(struct Kingdom *kingdom, struct HumanPopulation *world_stat, struct Human_Data *data)
+/**
+ * @brief Batch starvation kernel. Kills up to `quota` citizens of a kingdom in at most two sweeps.
+ * Those who are already starving (hunger <= 0) die first, then anyone else in the kingdom.
+ * In cohort mode the notables take their share and the cohorts the rest, hungriest first.
+ * @return The number of people who actually died.
+ */
+static int starve_population(struct Kingdom *kingdom, struct Human_Data *data, int quota)
 {
-    int military_count = 0;
-    int food_produced = 0; int stone_produced = 0;
-    int wood_produced = 0; int metal_produced = 0;
+    int begin, end;
+    kingdom_range(data, kingdom->id, &begin, &end);
+    int span = end - begin;
+    if (quota <= 0) return 0;
 
-    // --- Iterate over actual data count ---
-    for (int i = 0; i < data->count; i++)
-    {
-        if (data->humans[i].alive == 1)
-        {
-            if (data->humans[i].health <= 0) {
+    int starved = 0;
+    int start_offset = (span > 0) ? (int)(rng_next(&g_sim_rng) % (uint32_t)span) : 0;
+    int individual_quota = g_cohorts.enabled ? cohort_notable_quota(data, kingdom->id, 0, JOB_REBEL, quota) : quota;
+
+    for (int pass = 0; pass < 2 && starved < individual_quota && span > 0; pass++) {
+        for (int n = 0; n < span && starved < individual_quota; n++) {
+            int i = begin + (start_offset + n) % span;
+            if (data->humans[i].alive == 1 && data->humans[i].kingdom_id == kingdom->id &&
+                (pass == 1 || data->humans[i].hunger <= 0)) {
+                lifecycle_remove(&data->humans[i]);
                 data->humans[i].alive = 0;
-                continue;
+                starved++;
+            }
+        }
+    }
+    if (g_cohorts.enabled && starved < quota) {
+        starved += cohort_kill(kingdom->id, 0, JOB_REBEL, quota - starved, true);
+    }
+    return starved;
+}
+
+/**
+ * @brief Detects and resolves famine for a whole kingdom. Called once per simulated hour.
+ * While the granaries are empty, FAMINE_POPULATION_LOSS_PERCENT of the kingdom dies each hour
+ * and a single report is logged, no matter how large the population is.
+ */
+void update_kingdom_famine(struct Kingdom *kingdom, struct Human_Data *data)
+{
+    if (!kingdom->is_active) return;
+
+    if (kingdom->food > 1) {
+        if (kingdom->famine_hours > 0) {
+            log_event("The famine in %s has ended after %d hours.", kingdom->name, kingdom->famine_hours);
+            kingdom->famine_hours = 0;
+        }
+        return;
+    }
+
+    kingdom->food = 0;
+    kingdom->famine_hours++;
+    kingdom->unrest_level += UNREST_GAIN_FROM_FAMINE;
+
+    int deaths_from_starvation = (int)(kingdom->population * (FAMINE_POPULATION_LOSS_PERCENT / 100.0f));
+    if (deaths_from_starvation < 1 && kingdom->population > 0) deaths_from_starvation = 1;
+
+    int starved = starve_population(kingdom, data, deaths_from_starvation);
+    kingdom->population -= starved;
+
+    log_event("!!! FAMINE in %s !!! %d people have died from starvation.", kingdom->name, starved);
+}
+
+/**
+ * @brief One day's shift of work, and its wage, for every member of a single job.
+ * Straight-line code driven by the job's profile; the random numbers are drawn in bulk.
+ */
+static void run_job_kernel(const struct JobProfile *profile, struct Human_Data *data, const int *members, int member_count,
+                           struct Kingdom kingdoms[], int produced[NUM_KINGDOMS][RES_COUNT])
+{
+    uint32_t rolls[JOB_KERNEL_BLOCK * 3];
+
+    for (int base = 0; base < member_count; base += JOB_KERNEL_BLOCK) {
+        int block = (member_count - base < JOB_KERNEL_BLOCK) ? member_count - base : JOB_KERNEL_BLOCK;
+        rng_fill(&g_sim_rng, rolls, block * 3);
+
+        for (int b = 0; b < block; b++) {
+            struct Human_Stats *human = &data->humans[members[base + b]];
+            uint32_t work_roll = rolls[3 * b];
+            uint32_t output_roll = rolls[3 * b + 1];
+            uint32_t wage_roll = rolls[3 * b + 2];
+
+            // Everyone on the payroll is paid for the day, whether they worked or rested
+            if (profile->wage_range > 0) {
+                human->bronze += profile->wage_min + (int)(wage_roll % (uint32_t)profile->wage_range);
             }
 
             // Working consumes health and hunger
-            if (data->humans[i].health > 10){
-                int work = rand() % 2;
-                if (work >= 1) {
-                    switch (data->humans[i].job) {
-                        case JOB_FARMER:
-                            data->humans[i].health -= 5;
-                            data->humans[i].hunger -= 10;
-                            food_produced += (rand() % FARMER_FOOD_PRODUCTION);
-                            break;
-                        case JOB_BUTCHER:
-                              data->humans[i].health -= 10;
-                            data->humans[i].hunger -= 15;
-                            food_produced += (rand() % BUTCHER_MEAT_PRODUCTION);
-                            break;
-                        case JOB_LUMBERJACK:
-                            data->humans[i].health -= 15;
-                            data->humans[i].hunger -= 20;
-                            wood_produced += (rand() % LUMBERJACK_WOOD_PRODUCTION)+1;
-                            break;
-                        case JOB_MINER:
-                            data->humans[i].health -= 30;
-                            data->humans[i].hunger -= 35;
-                            if (rand() % 100 < MINER_METAL_CHANCE_PERCENT) {
-                                metal_produced += (rand() % MINER_METAL_PRODUCTION)+1;
-                            } else {
-                                stone_produced += (rand() % MINER_STONE_PRODUCTION)+1;
-                            }
-                            break;
-                        case JOB_BLACKSMITH:
-                            if (kingdom->metal > 2){
-                                data->humans[i].health -= 20;
-                                data->humans[i].hunger -= 25;
-                                kingdom->metal -= BLACKSMITH_METAL_NEEDS;
-                            } else {data->humans[i].hunger -= 10;}
-                            break;
-                        case JOB_SWORDSMAN:
-                        case JOB_ARCHER:
-                        case JOB_CAVALRY: // The army needs to train.
-                            data->humans[i].health -= 5;
-                            data->humans[i].hunger -= 10;
-                        case JOB_REBEL:
-                            break;
-                    }
-                } else {
-                    data->humans[i].health += 20; // Preventing helps more
+            if (human->health <= EXHAUSTED_HEALTH_THRESHOLD) {
+                human->health += EXHAUSTED_HEALTH_RECOVERY; // Didn't prevent well, slower recovery.
+                continue;
+            }
+            if ((work_roll & 1) == 0) {
+                human->health += REST_HEALTH_RECOVERY; // Preventing helps more
+                continue;
+            }
+
+            if (profile->metal_needed > 0) {
+                struct Kingdom *kingdom = &kingdoms[human->kingdom_id];
+                if (kingdom->metal < profile->metal_needed) {
+                    human->hunger -= profile->idle_hunger_cost;
+                    continue;
                 }
-            }else {
-                data->humans[i].health += 5; // Didn't prevent well, slower recovery.
+                kingdom->metal -= profile->metal_needed;
             }
 
-            // Should add a logic specific for rebels.
-            if (data->humans[i].job != JOB_REBEL) consume_resources(kingdom, data, i);
+            human->health -= profile->health_cost;
+            human->hunger -= profile->hunger_cost;
 
+            if (profile->alt_chance_percent > 0 && (int)((work_roll >> 1) % 100) < profile->alt_chance_percent) {
+                produced[human->kingdom_id][profile->alt_resource] += profile->alt_min + (int)(output_roll % (uint32_t)profile->alt_range);
+            } else if (profile->resource != RES_NONE) {
+                produced[human->kingdom_id][profile->resource] += profile->output_min + (int)(output_roll % (uint32_t)profile->output_range);
+            }
         }
     }
+}
+
+/**
+ * @brief Adds a day's output to the granaries and storehouses, then applies the story and
+ * divine modifiers.
+ */
+static void deliver_production(struct Kingdom kingdoms[], int produced[NUM_KINGDOMS][RES_COUNT])
+{
+    for (int k = 0; k < NUM_KINGDOMS; k++) {
+        struct Kingdom *kingdom = &kingdoms[k];
+        if (!kingdom->is_active) continue;
 
-    kingdom->food += food_produced;
-    kingdom->wood += wood_produced;
-    kingdom->stone += stone_produced;
-    kingdom->metal += metal_produced;
+        kingdom->food += produced[k][RES_FOOD];
+        kingdom->wood += produced[k][RES_WOOD];
+        kingdom->stone += produced[k][RES_STONE];
+        kingdom->metal += produced[k][RES_METAL];
 
-    apply_production_effects(kingdom);
+        apply_production_effects(kingdom);
 
-    // Apply story food cap // CHECK ON THIS MIGHT SOLVE THE STRANGE FOOD BEHAVIOUR YOU'VE BEN HAVING TO STABILISE THINGS
-    if (kingdom->story_food_daily_cap > 0 && kingdom->food > kingdom->story_food_daily_cap) {
-        kingdom->food = kingdom->story_food_daily_cap;
+        // Apply story food cap // CHECK ON THIS MIGHT SOLVE THE STRANGE FOOD BEHAVIOUR YOU'VE BEN HAVING TO STABILISE THINGS
+        if (kingdom->story_food_daily_cap > 0 && kingdom->food > kingdom->story_food_daily_cap) {
+            kingdom->food = kingdom->story_food_daily_cap;
+        }
     }
 }
 
+/**
+ * @brief Works, pays and feeds every citizen of `data` who hasn't worked on `work_day` yet.
+ * The work schedule hands out slices of the population; each citizen is stamped with the day
+ * so that nobody works twice, even when the slices overlap.
+ */
+void dailyneed(struct Kingdom kingdoms[], struct HumanPopulation *world_stat, struct Human_Data *data, int work_day)
+{
+    int produced[NUM_KINGDOMS][RES_COUNT] = {{0}};
 
+    // --- Group the working population by job ---
+    int job_sizes[JOB_REBEL + 1] = {0};
+    int job_starts[JOB_REBEL + 2] = {0};
+    int *members = human_scratch(data, data->count > 0 ? data->count : 1);
+    if (members == NULL) return;
 
+    for (int i = 0; i < data->count; i++) {
+        if (data->humans[i].alive != 1 || data->humans[i].work_day == work_day) continue;
+        if (data->humans[i].health <= 0) {
+            lifecycle_remove(&data->humans[i]);
+            data->humans[i].alive = 0;
+            continue;
+        }
+        int job = data->humans[i].job;
+        int k = data->humans[i].kingdom_id;
+        if (job < 0 || job > JOB_REBEL || k < 0 || k >= NUM_KINGDOMS) continue;
+        job_sizes[job]++;
+    }
+    for (int j = 0; j <= JOB_REBEL; j++) job_starts[j + 1] = job_starts[j] + job_sizes[j];
+
+    int fill[JOB_REBEL + 1];
+    memcpy(fill, job_starts, sizeof(fill));
+    for (int i = 0; i < data->count; i++) {
+        int job = data->humans[i].job;
+        int k = data->humans[i].kingdom_id;
+        if (data->humans[i].alive != 1 || data->humans[i].work_day == work_day) continue;
+        if (job < 0 || job > JOB_REBEL || k < 0 || k >= NUM_KINGDOMS) continue;
+        data->humans[i].work_day = work_day;
+        members[fill[job]++] = i;
+    }
+    int member_count = job_starts[JOB_REBEL + 1];
+
+    // --- Work Phase: one kernel per job ---
+    for (int j = 0; j <= JOB_REBEL; j++) {
+        run_job_kernel(&job_profiles[j], data, &members[job_starts[j]], job_sizes[j], kingdoms, produced);
+    }
+
+    // --- Consumption Phase: rationed, so every citizen can be fed independently ---
+    struct FoodRationPlan plan;
+    plan_food_rations(&plan, kingdoms, data, members, member_count);
+    struct RngStream rng;
+    rng_seed(&rng, ((uint64_t)rng_next(&g_sim_rng) << 32) | rng_next(&g_sim_rng));
+    for (int m = 0; m < member_count; m++) {
+        int i = members[m];
+        // Should add a logic specific for rebels.
+        if (data->humans[i].alive == 1 && data->humans[i].job != JOB_REBEL) consume_resources(&plan, data, i, &rng);
+    }
+
+    deliver_production(kingdoms, produced);
+}
+
+/**
+ * @brief Share of a hunger bucket's members who are at or below the eating threshold.
+ */
+static double cohort_eating_share(int hunger_bucket)
+{
+    double share = (double)(EAT_HUNGER_THRESHOLD + 1 - hunger_bucket * COHORT_HUNGER_BUCKET_WIDTH) / COHORT_HUNGER_BUCKET_WIDTH;
+    if (share < 0.0) return 0.0;
+    if (share > 1.0) return 1.0;
+    return share;
+}
+
+/**
+ * @brief One day of work, wages and meals for every cohort. The cohort counterpart of dailyneed:
+ * each step splits a cohort the way the individual rolls would split its members.
+ */
+void cohort_work_day(struct Kingdom kingdoms[])
+{
+    static CohortKingdom staged; // Members land here so nobody is handled twice
+    static int eaters[JOB_REBEL + 1][COHORT_HEALTH_BUCKETS][COHORT_HUNGER_BUCKETS];
+    int produced[NUM_KINGDOMS][RES_COUNT] = {{0}};
+
+    for (int k = 0; k < NUM_KINGDOMS; k++) {
+        struct Kingdom *kingdom = &kingdoms[k];
+        if (!kingdom->is_active) continue;
+        CohortKingdom *cells = &g_cohorts.cells[k];
+
+        // --- Work Phase ---
+        memset(staged, 0, sizeof(staged));
+        for (int j = 0; j <= JOB_REBEL; j++) {
+            const struct JobProfile *profile = &job_profiles[j];
+            for (int h = 0; h < COHORT_HEALTH_BUCKETS; h++)
+                for (int g = 0; g < COHORT_HUNGER_BUCKETS; g++) {
+                    struct Cohort workers = (*cells)[j][h][g];
+                    if (workers.count == 0) continue;
+
+                    if (profile->wage_range > 0) {
+                        workers.bronze += cohort_sum_uniform(workers.count, profile->wage_min, profile->wage_range);
+                    }
+
+                    // The lowest health bucket holds the exhausted, who can only recover
+                    int exhausted = (h == 0) ? cohort_binomial(workers.count, (double)(EXHAUSTED_HEALTH_THRESHOLD + 1) / COHORT_HEALTH_BUCKET_WIDTH) : 0;
+                    cohort_place(staged, j, h, g, cohort_take(&workers, exhausted), EXHAUSTED_HEALTH_RECOVERY, 0);
+                    cohort_place(staged, j, h, g, cohort_take(&workers, cohort_binomial(workers.count, 0.5)), REST_HEALTH_RECOVERY, 0);
+
+                    if (profile->metal_needed > 0) {
+                        int supplied = kingdom->metal / profile->metal_needed;
+                        if (supplied < workers.count) {
+                            cohort_place(staged, j, h, g, cohort_take(&workers, workers.count - supplied), 0, -profile->idle_hunger_cost);
+                        }
+                        kingdom->metal -= workers.count * profile->metal_needed;
+                    }
+
+                    int strikes = (profile->alt_chance_percent > 0) ? cohort_binomial(workers.count, profile->alt_chance_percent / 100.0) : 0;
+                    if (strikes > 0) {
+                        produced[k][profile->alt_resource] += (int)cohort_sum_uniform(strikes, profile->alt_min, profile->alt_range);
+                    }
+                    if (profile->resource != RES_NONE) {
+                        produced[k][profile->resource] += (int)cohort_sum_uniform(workers.count - strikes, profile->output_min, profile->output_range);
+                    }
+
+                    cohort_place(staged, j, h, g, workers, -profile->health_cost, -profile->hunger_cost);
+                }
+        }
+        memcpy(*cells, staged, sizeof(staged));
+
+        // --- Consumption Phase: the same ration plan as the individuals ---
+        bool famine = (kingdom->food <= 1);
+        int total_demand = 0;
+        for (int j = 0; j < JOB_REBEL; j++)
+            for (int h = 0; h < COHORT_HEALTH_BUCKETS; h++)
+                for (int g = 0; g < COHORT_HUNGER_BUCKETS; g++) {
+                    const struct Cohort *cell = &(*cells)[j][h][g];
+                    eaters[j][h][g] = famine ? 0 : cohort_binomial(cell->count, cohort_eating_share(g));
+                    if (cell->bronze >= (long long)cell->count * FOOD_COST) {
+                        total_demand += eaters[j][h][g] * food_ration_size(j);
+                    }
+                }
+
+        float ration = 0.0f;
+        if (!famine && total_demand > 0) {
+            if (kingdom->food >= total_demand) {
+                ration = 1.0f;
+                kingdom->food -= total_demand;
+            } else {
+                ration = (float)kingdom->food / (float)total_demand;
+                kingdom->food = 0;
+            }
+        }
+
+        memset(staged, 0, sizeof(staged));
+        for (int j = 0; j <= JOB_REBEL; j++)
+            for (int h = 0; h < COHORT_HEALTH_BUCKETS; h++)
+                for (int g = 0; g < COHORT_HUNGER_BUCKETS; g++) {
+                    struct Cohort rest = (*cells)[j][h][g];
+                    if (rest.count == 0) continue;
+
+                    if (j != JOB_REBEL && famine) {
+                        cohort_place(staged, j, h, g, rest, 0, -FAMINE_HOURLY_HUNGER_LOSS);
+                        continue;
+                    }
+                    if (j != JOB_REBEL && eaters[j][h][g] > 0) {
+                        bool can_pay = rest.bronze >= (long long)rest.count * FOOD_COST;
+                        struct Cohort hungry = cohort_take(&rest, eaters[j][h][g]);
+                        if (can_pay) {
+                            hungry.bronze -= (long long)hungry.count * (int)(FOOD_COST * ration + 0.5f);
+                            int meal = (int)((double)cohort_sum_uniform(hungry.count, 10, 40) * ration / hungry.count + 0.5);
+                            cohort_place(staged, j, h, g, hungry, 0, meal);
+                        } else {
+                            cohort_place(staged, j, h, g, hungry, -5, 0);
+                        }
+                    }
+                    cohort_place(staged, j, h, g, rest, 0, 0);
+                }
+        memcpy(*cells, staged, sizeof(staged));
+    }
+
+    deliver_production(kingdoms, produced);
+}
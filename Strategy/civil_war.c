@@ -21,7 +21,9 @@ static void run_battle(struct Kingdom *kingdom, struct Human_Data *data, int imp
     // --- OPTIMIZATION: Combine loops for finding leaders ---
     int general_count = 0;
     int rebel_leader_count = 0;
-    for (int i = 0; i < data->count; i++) {
+    int begin, end;
+    kingdom_range(data, kingdom->id, &begin, &end);
+    for (int i = begin; i < end; i++) {
         if (data->humans[i].alive == 1 &&
             data->humans[i].is_general == 1 &&
             data->humans[i].kingdom_id == kingdom->id)
@@ -4,9 +4,13 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <math.h>
+#include <limits.h>
 #include "../humans.h"
 #include "../logger.h"
 #include "../game_config.h"
+#include "../rng.h"
+#include "../cohorts.h"
+#include "../lifecycle.h"
 
 /**
  * @brief Kills a specified number of random, living people of a certain job in a kingdom.
@@ -21,20 +25,30 @@ void inflict_casualties(struct Human_Data *data, int kingdom_id, int job_id, int
 
     int casualties_inflicted = 0;
     int attempts = 0; // Safety break to prevent infinite loops
+    int begin, end;
+    kingdom_range(data, kingdom_id, &begin, &end);
+    int span = end - begin;
+
+    // In cohort mode humans[] only holds the notables, who take their fair share of the losses
+    int individual_casualties = g_cohorts.enabled ? cohort_notable_quota(data, kingdom_id, job_id, job_id, count) : count;
     
     // This is a simple but effective randomization method for large populations.
-    while (casualties_inflicted < count && attempts < data->count * 3) {
-        int random_index = rand() % data->count;
+    while (span > 0 && casualties_inflicted < individual_casualties && attempts < span * 3) {
+        int random_index = begin + rand() % span;
         
         if (data->humans[random_index].alive == 1 &&
             data->humans[random_index].kingdom_id == kingdom_id &&
             data->humans[random_index].job == job_id)
         {
+            lifecycle_remove(&data->humans[random_index]);
             data->humans[random_index].alive = 0;
             casualties_inflicted++;
         }
         attempts++;
     }
+    if (g_cohorts.enabled && casualties_inflicted < count) {
+        cohort_kill(kingdom_id, job_id, job_id, count - casualties_inflicted, false);
+    }
 }
 
 
@@ -150,6 +164,28 @@ int declare_result(int rebel_count, int soldier_count, int residual_rebel_count,
         return 3; // Continue the battle
     }
 }
+/**
+ * @brief Keeps a side's summed strength inside an int; very large cohort armies saturate.
+ */
+static int clamp_strength(long long value)
+{
+    return (value > INT_MAX / 4) ? INT_MAX / 4 : (int)value;
+}
+
+/**
+ * @brief Adds one job's cohorts to a side of a skirmish: head count plus health, damage and defense totals.
+ */
+static void add_cohort_fighters(int kingdom_id, int job, int *count, long long totals[3])
+{
+    int fighters;
+    long long health, damage, defense;
+    cohort_battle_stats(kingdom_id, job, &fighters, &health, &damage, &defense);
+    *count += fighters;
+    totals[0] += health;
+    totals[1] += damage;
+    totals[2] += defense;
+}
+
 // NEXT UPDATE: ALL FOOD, EQUIPMENT, etc BOUGHT BY THE POPULATION. 30% of the money goes in the treasury.
 
 /**
@@ -185,7 +221,9 @@ void trigger_hourly_skirmish(struct Kingdom *kingdom, struct Human_Data *data) {
         int cavalry_count = 0;
 
 
-        for (int i = 0; i < data->count; i++)
+        int begin, end;
+        kingdom_range(data, kingdom->id, &begin, &end);
+        for (int i = begin; i < end; i++)
         {
             if (data->humans[i].alive == 1 && data->humans[i].kingdom_id == kingdom->id) {
                 switch (data->humans[i].job)
@@ -224,6 +262,22 @@ void trigger_hourly_skirmish(struct Kingdom *kingdom, struct Human_Data *data) {
             }
         }
  
+        if (g_cohorts.enabled) {
+            long long totals[3] = {0};
+            add_cohort_fighters(kingdom->id, JOB_SWORDSMAN, &swordsman_count, totals);
+            add_cohort_fighters(kingdom->id, JOB_ARCHER, &archer_count, totals);
+            add_cohort_fighters(kingdom->id, JOB_CAVALRY, &cavalry_count, totals);
+            soldier_health = clamp_strength(soldier_health + totals[0]);
+            soldier_damage = clamp_strength(soldier_damage + totals[1]);
+            soldier_defense = clamp_strength(soldier_defense + totals[2]);
+
+            totals[0] = totals[1] = totals[2] = 0;
+            add_cohort_fighters(kingdom->id, JOB_REBEL, &rebel_count, totals);
+            rebel_health = clamp_strength(rebel_health + totals[0]);
+            rebel_damage = clamp_strength(rebel_damage + totals[1]);
+            rebel_defense = clamp_strength(rebel_defense + totals[2]);
+        }
+
         soldier_count = swordsman_count + archer_count + cavalry_count;
 
         // A skirmish can only happen if both sides have people to fight
@@ -314,50 +368,19 @@ void update_kingdom_unrest(struct Kingdom *kingdom, struct Human_Data *data) {
 
 
 /**
- * @brief Manages dissent and military recruitment.
- * REVISED: Separates logic for civilians and soldiers to ensure both can become rebels.
- * Soldiers now have a slightly lower chance to defect.
+ * @brief Sets today's odds of dissent for the daily pass.
+ * Soldiers have a slightly lower chance to defect than civilians.
  */
-void handle_recruitment_and_dissent(struct Kingdom *kingdom, struct Human_Data *data) {
-    if (!kingdom->is_active || kingdom->unrest_level <= DISSENT_THRESHOLD) return;
+void prepare_dissent(struct Kingdom *kingdom, struct KingdomDay *day) {
+    day->dissent_active = kingdom->is_active && kingdom->unrest_level > DISSENT_THRESHOLD;
+    if (!day->dissent_active) return;
 
-    int new_rebels_this_day = 0;
-    const int max_new_rebels_per_day = MAX_NEW_REBELS_PER_DAY;
     int unrest_over_threshold = kingdom->unrest_level - DISSENT_THRESHOLD;
     if (unrest_over_threshold > MAX_UNREST_FOR_REBEL_CONVERSION) {
         unrest_over_threshold = MAX_UNREST_FOR_REBEL_CONVERSION;
     }
-
-    for (int i = 0; i < data->count; i++) {
-        if (data->humans[i].alive == 0 || data->humans[i].job == JOB_REBEL || data->humans[i].kingdom_id != kingdom->id) continue;
-        if (new_rebels_this_day >= MAX_NEW_REBELS_PER_DAY) break; 
-
-        bool is_soldier = (data->humans[i].job >= JOB_SWORDSMAN && data->humans[i].job <= JOB_CAVALRY);
-        bool became_rebel = false;
-
-        if (is_soldier) {
-            int soldier_defection_chance = unrest_over_threshold * SOLDIER_DEFECTION_CHANCE_MODIFIER;
-            if ((rand() % REBEL_CHANCE_DIVISOR) < soldier_defection_chance) { 
-                kingdom->army_morale -= 5;
-                data->humans[i].job = JOB_REBEL;
-                became_rebel = true;
-            }
-        } else {
-            if ((rand() % REBEL_CHANCE_DIVISOR) < unrest_over_threshold) { 
-                data->humans[i].job = JOB_REBEL;
-                became_rebel = true;
-            } 
-        }
-
-        if (became_rebel) {
-            new_rebels_this_day++;
-            if (rand() % 100 < REBEL_LEADER_SPAWN_CHANCE_PERCENT) { 
-                data->humans[i].is_general = 1;
-            }
-        }
-    }
-
-    if (kingdom->army_morale < 0) kingdom->army_morale = 0;
+    day->civilian_rebel_chance = unrest_over_threshold;
+    day->soldier_defection_chance = unrest_over_threshold * SOLDIER_DEFECTION_CHANCE_MODIFIER;
 }
 
 /**
@@ -378,6 +401,12 @@ int check_civil_war_trigger(struct Human_Data *data) {
             }
         }
     }
+    if (g_cohorts.enabled) {
+        for (int k = 0; k < NUM_KINGDOMS; k++) {
+            for (int job = JOB_SWORDSMAN; job <= JOB_CAVALRY; job++) soldier_count += cohort_job_count(k, job);
+            rebel_count += cohort_job_count(k, JOB_REBEL);
+        }
+    }
     
     // Trigger condition: There must be a significant number of rebels, and they must be
     // numerous enough to challenge the army (e.g., at least 75% of the army's size).
@@ -388,11 +417,26 @@ int check_civil_war_trigger(struct Human_Data *data) {
     return 0;
 }
 
+/**
+ * @brief Sends one citizen of the fallen Empire to a random successor kingdom.
+ * Runs on the worker threads during the collapse, with a random stream per chunk.
+ */
+static void join_successor_kingdom(struct Human_Stats *human, struct RngStream *rng, void *context) {
+    (void)context;
+    human->kingdom_id = (int)(rng_next(rng) % (NUM_KINGDOMS - 1)) + 1;
+
+    if (human->job >= JOB_SWORDSMAN) {
+        human->job = JOB_FARMER; // Former rebels/soldiers become farmers.
+    }
+}
+
 /**
  * @brief The special event for the Empire's collapse.
+ * Every living human is sent to one of the seven successor kingdoms, and the population is
+ * regrouped into kingdom shards in the same parallel pass.
  * @return Returns 1 if the empire fell, 0 otherwise.
  */
-int check_for_empire_collapse(struct Kingdom kingdoms[], struct Human_Data *data, int total_population) {
+int check_for_empire_collapse(struct Kingdom kingdoms[], struct Human_Data *data) {
     if (!kingdoms[0].is_active || kingdoms[0].unrest_level < REBELLION_THRESHOLD) {
         return 0; // Not enough unrest, or empire already fell.
     }
@@ -401,31 +445,19 @@ int check_for_empire_collapse(struct Kingdom kingdoms[], struct Human_Data *data
     log_event("From the ashes, 7 new kingdoms arise!");
 
     kingdoms[0].is_active = 0; // The Empire is no more.
+    kingdoms[0].population = 0;
+
+    // Reassign every living human to one of the new kingdoms, and count them on the way.
+    int census[NUM_KINGDOMS] = {0};
+    repartition_population(data, join_successor_kingdom, NULL, census);
+    if (g_cohorts.enabled) cohort_collapse_empire();
 
     // Activate the 7 new kingdoms. Names are assigned in kingdoms.c
-    for (int i = 1; i <= 7; i++) {
+    for (int i = 1; i < NUM_KINGDOMS; i++) {
         kingdoms[i].is_active = 1;
-        kingdoms[i].population = 0;
-    }
-
-    // Reassign every living human to one of the new kingdoms.
-    for (int i = 0; i < total_population; i++) {
-        if (data->humans[i].alive == 1) {
-            int new_kingdom_id = (rand() % 7) + 1;
-            data->humans[i].kingdom_id = new_kingdom_id;
-
-            if (data->humans[i].job == 6 || data->humans[i].job == 7) {
-                data->humans[i].job = 1; // Former rebels/soldiers become farmers.
-            }
-        }
-    }
-    
-    // Recalculate populations for the new kingdoms
-    for(int i = 0; i < total_population; i++) {
-        if(data->humans[i].alive == 1) {
-            kingdoms[data->humans[i].kingdom_id].population++;
-        }
+        kingdoms[i].population = census[i];
+        if (g_cohorts.enabled) kingdoms[i].population += cohort_population(i);
     }
 
     return 1; // The empire has fallen.
-}
\ No newline at end of file
+}
@@ -0,0 +1,175 @@
+// file: pack_story.c
+//
+// Writes the story pack the game reads its chapters and characters from (see story_pack.h),
+// using the text in story_data.h and characters.h. Run it whenever the story changes:
+//
+//     gcc -o pack_story Tools/pack_story.c && ./pack_story story.pack
+//
+// The game looks for story.pack next to its executable.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../story_data.h"
+#include "../characters.h"
+#include "../story_pack.h"
+
+#define MAX_PERSPECTIVES 64
+
+// The text blob being built
+static char *text;
+static size_t text_size;
+static size_t text_capacity;
+
+static uint32_t add_text(const char *string)
+{
+    size_t length = strlen(string) + 1;
+    if (text_size + length > text_capacity) {
+        size_t new_capacity = text_capacity > 0 ? text_capacity * 2 : 65536;
+        while (new_capacity < text_size + length) new_capacity *= 2;
+        char *grown = realloc(text, new_capacity);
+        if (grown == NULL) {
+            fprintf(stderr, "Error: Failed to allocate memory for the story text.\n");
+            exit(1);
+        }
+        text = grown;
+        text_capacity = new_capacity;
+    }
+    memcpy(text + text_size, string, length);
+    text_size += length;
+    return (uint32_t)(text_size - length);
+}
+
+static uint64_t hash_bytes(uint64_t hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < size; i++) hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    return hash;
+}
+
+// Names are collected while the chapters are packed and added to the blob after them, so a
+// chapter's stretch of the blob holds only its own text
+static const char *perspective_names[MAX_PERSPECTIVES];
+static uint32_t perspectives[MAX_PERSPECTIVES];
+static int perspective_count;
+
+static uint32_t find_perspective(const char *name)
+{
+    for (int i = 0; i < perspective_count; i++) {
+        if (strcmp(perspective_names[i], name) == 0) return (uint32_t)i;
+    }
+    if (perspective_count == MAX_PERSPECTIVES) {
+        fprintf(stderr, "Error: More than %d perspectives in the story.\n", MAX_PERSPECTIVES);
+        exit(1);
+    }
+    perspective_names[perspective_count] = name;
+    return (uint32_t)perspective_count++;
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = (argc > 1) ? argv[1] : STORY_PACK_FILE;
+    const int chapter_count = (int)TOTAL_CHAPTERS;
+
+    int paragraph_total = 0;
+    for (int c = 0; c < chapter_count; c++) paragraph_total += story[c].paragraph_count;
+
+    struct StoryPackChapter *chapters = calloc(chapter_count, sizeof(*chapters));
+    struct StoryPackParagraph *paragraphs = calloc(paragraph_total > 0 ? paragraph_total : 1, sizeof(*paragraphs));
+    struct StoryPackCharacter *character_table = calloc(TOTAL_CHARACTERS > 0 ? TOTAL_CHARACTERS : 1, sizeof(*character_table));
+    if (chapters == NULL || paragraphs == NULL || character_table == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for the story tables.\n");
+        return 1;
+    }
+
+    find_perspective("Narrator"); // Always perspective 0 (STORY_PACK_NARRATOR)
+
+    // Each chapter's title and paragraphs go into the blob together, so reading a
+    // chapter touches one stretch of the file
+    uint32_t paragraph_index = 0;
+    for (int c = 0; c < chapter_count; c++) {
+        const Chapter *chapter = &story[c];
+        chapters[c].title = add_text(chapter->title);
+        chapters[c].first_paragraph = paragraph_index;
+
+        // paragraph_count may overshoot the NULL that ends the array; the NULL wins.
+        // Perspective arrays end with NULL too, except the single-entry narrator one.
+        bool perspectives_ended = (chapter->perspectives == NULL || chapter->perspectives == narrator_perspective);
+        int p = 0;
+        for (; p < chapter->paragraph_count && chapter->paragraphs[p] != NULL; p++) {
+            if (!perspectives_ended && chapter->perspectives[p] == NULL) perspectives_ended = true;
+            const char *perspective = perspectives_ended ? "Narrator" : chapter->perspectives[p];
+            paragraphs[paragraph_index].text = add_text(chapter->paragraphs[p]);
+            paragraphs[paragraph_index].perspective = find_perspective(perspective);
+            paragraph_index++;
+        }
+        if (p == 0) {
+            fprintf(stderr, "Error: '%s' has no paragraphs.\n", chapter->title);
+            return 1;
+        }
+        if (p != chapter->paragraph_count) {
+            printf("Note: '%s' claims %d paragraphs but has %d.\n", chapter->title, chapter->paragraph_count, p);
+        }
+        chapters[c].paragraph_count = (uint32_t)p;
+        chapters[c].text_end = (uint32_t)text_size;
+        chapters[c].checksum = hash_bytes(14695981039346656037ULL, text + chapters[c].title, text_size - chapters[c].title);
+    }
+
+    // Everything after the chapters is covered by one checksum
+    size_t extras_at = text_size;
+    for (int i = 0; i < perspective_count; i++) perspectives[i] = add_text(perspective_names[i]);
+    for (int i = 0; i < TOTAL_CHARACTERS; i++) {
+        character_table[i].name = add_text(characters[i].name);
+        character_table[i].title = add_text(characters[i].title);
+        character_table[i].description = add_text(characters[i].description);
+    }
+
+    struct StoryPackHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, STORY_PACK_MAGIC, sizeof(header.magic));
+    header.version = STORY_PACK_VERSION;
+    header.chapter_count = (uint32_t)chapter_count;
+    header.paragraph_count = paragraph_index;
+    header.perspective_count = (uint32_t)perspective_count;
+    header.character_count = (uint32_t)TOTAL_CHARACTERS;
+    header.chapters_at = sizeof(header);
+    header.paragraphs_at = header.chapters_at + header.chapter_count * sizeof(struct StoryPackChapter);
+    header.perspectives_at = header.paragraphs_at + header.paragraph_count * sizeof(struct StoryPackParagraph);
+    header.characters_at = header.perspectives_at + header.perspective_count * sizeof(uint32_t);
+    header.text_at = header.characters_at + header.character_count * sizeof(struct StoryPackCharacter);
+    header.text_size = (uint32_t)text_size;
+
+    header.extras_checksum = hash_bytes(14695981039346656037ULL, text + extras_at, text_size - extras_at);
+
+    // The tables, in the order they are written
+    uint64_t checksum = 14695981039346656037ULL;
+    checksum = hash_bytes(checksum, chapters, header.chapter_count * sizeof(*chapters));
+    checksum = hash_bytes(checksum, paragraphs, header.paragraph_count * sizeof(*paragraphs));
+    checksum = hash_bytes(checksum, perspectives, header.perspective_count * sizeof(uint32_t));
+    header.tables_checksum = hash_bytes(checksum, character_table, header.character_count * sizeof(*character_table));
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Error: Could not create '%s'.\n", path);
+        return 1;
+    }
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(chapters, sizeof(*chapters), header.chapter_count, file) == header.chapter_count &&
+                   fwrite(paragraphs, sizeof(*paragraphs), header.paragraph_count, file) == header.paragraph_count &&
+                   fwrite(perspectives, sizeof(uint32_t), header.perspective_count, file) == header.perspective_count &&
+                   fwrite(character_table, sizeof(*character_table), header.character_count, file) == header.character_count &&
+                   fwrite(text, 1, text_size, file) == text_size;
+    if (fclose(file) != 0) written = false;
+    if (!written) {
+        fprintf(stderr, "Error: Could not write '%s'.\n", path);
+        return 1;
+    }
+
+    printf("Packed %d chapters, %u paragraphs, %d perspectives and %d characters (%zu bytes of text) into '%s'.\n",
+           chapter_count, header.paragraph_count, perspective_count, TOTAL_CHARACTERS, text_size, path);
+    free(chapters);
+    free(paragraphs);
+    free(character_table);
+    free(text);
+    return 0;
+}
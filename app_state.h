@@ -17,6 +17,10 @@ typedef struct AppState {
     int log_autoscroll_state; // 0=idle, 1=content added, 2=ready to scroll
     int last_log_write_index;
     bool show_policies_window;
+    bool show_history_window;
+    int history_kingdom; // What the History window charts
+    int history_metric;
+    int history_span;
     bool is_modal_active;
 } AppState;
 
@@ -0,0 +1,77 @@
+// file: cohorts.h
+
+#ifndef COHORTS_H
+#define COHORTS_H
+
+#include <stdbool.h>
+#include "humans.h"
+
+// --- Cohort population model ---
+// Instead of one Human_Stats per citizen, interchangeable citizens are counted in cohorts
+// keyed by (kingdom, job, health bucket, hunger bucket). Every stage that
+// works on individuals has a cohort counterpart that draws the same random outcomes from
+// their distributions (binomial splits, sums of uniform rolls), so a kingdom's trajectory
+// matches the individual model statistically at a cost that doesn't grow with population.
+// Selected at startup with --cohorts. Notables (generals and rebel leaders) stay individual
+// Human_Stats in humans[], so battles and the story still see them one by one.
+
+#define COHORT_HEALTH_BUCKETS 8
+#define COHORT_HEALTH_BUCKET_WIDTH 32   // Health 0-255; bucket 0 holds the exhausted
+#define COHORT_HUNGER_BUCKETS 8
+#define COHORT_HUNGER_BUCKET_WIDTH 20   // Hunger 0-159; bucket 0 holds the starving
+
+struct Cohort {
+    int count;
+    long long bronze;    // Totals over all members, so averages survive splits and merges
+    long long damage;
+    long long defense;
+};
+
+// One kingdom's cohorts, indexed [job][health bucket][hunger bucket]
+typedef struct Cohort CohortKingdom[JOB_REBEL + 1][COHORT_HEALTH_BUCKETS][COHORT_HUNGER_BUCKETS];
+
+struct CohortPopulation {
+    bool enabled;
+    CohortKingdom cells[NUM_KINGDOMS];
+};
+
+// Defined in cohorts.c. Only the simulation thread touches it.
+extern struct CohortPopulation g_cohorts;
+
+// Sampling
+int cohort_binomial(int n, double p);
+long long cohort_sum_uniform(int n, int min, int range);
+
+// Setup and bookkeeping
+void cohorts_init(int population, struct Human_Data *data);
+int cohort_health_bucket(int health);
+int cohort_hunger_bucket(int hunger);
+struct Cohort cohort_take(struct Cohort *from, int n);
+void cohort_merge(struct Cohort *into, const struct Cohort *group);
+int cohort_place(CohortKingdom into, int job, int health_bucket, int hunger_bucket,
+                 struct Cohort group, int health_change, int hunger_change);
+int cohort_population(int kingdom_id);
+int cohort_job_count(int kingdom_id, int job);
+
+// Population changes
+void cohort_add_members(int kingdom_id, int job, int count, int health, int hunger);
+void cohort_births(struct Kingdom kingdoms[], const int births[NUM_KINGDOMS]);
+void cohort_natural_deaths(int count);
+int cohort_kill(int kingdom_id, int first_job, int last_job, int count, bool hungriest_first);
+int cohort_move_jobs(int kingdom_id, int from_job, int to_job, int count);
+int cohort_pick_civilian_job(int kingdom_id);
+void cohort_add_bronze(int kingdom_id, int amount_each);
+void cohort_collapse_empire(void);
+
+// Notables
+bool cohort_is_notable(const struct Human_Stats *human);
+int cohort_promote(struct Human_Data *data, int kingdom_id, int job, int count);
+int cohort_demote_ordinary(struct Human_Data *data);
+int cohort_notable_quota(const struct Human_Data *data, int kingdom_id, int first_job, int last_job, int count);
+
+// Daily stages
+void cohort_daily_pass(struct KingdomDay days[], const bool managed[]);
+void cohort_work_day(struct Kingdom kingdoms[]);
+void cohort_battle_stats(int kingdom_id, int job, int *count, long long *health, long long *damage, long long *defense);
+
+#endif // COHORTS_H
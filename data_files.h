@@ -0,0 +1,13 @@
+// file: data_files.h
+
+#ifndef DATA_FILES_H
+#define DATA_FILES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Finds a data file (fonts, the story pack) next to the executable, falling back to the
+// working directory. Returns true and the path in `out` if the file exists.
+bool find_data_file(const char *argv0, const char *relative_path, char *out, size_t out_size);
+
+#endif // DATA_FILES_H
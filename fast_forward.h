@@ -0,0 +1,23 @@
+// file: fast_forward.h
+
+#ifndef FAST_FORWARD_H
+#define FAST_FORWARD_H
+
+#include "humans.h"
+
+// Advances quiet stretches of the night in one step instead of one tick per hour.
+// An hour is quiet when nothing in it depends on individual citizens: no work, no council,
+// no rebels to skirmish with, no famine, no scripted skirmish pending and no story position
+// or player orders waiting to be taken. With work and the council excluded, that leaves the
+// hours from midnight to WORK_START_HOUR and the one from WORK_END_HOUR to the council.
+// Then the only change is the steady birth and death rate, which is summed for the whole
+// stretch and applied at once, followed by a single census. The stretch ends at the first
+// hour that needs the full simulation again.
+
+// Advances the quiet hours starting at `hour` of `day` and returns how many were advanced
+// (0 if `hour` itself is not quiet). `rebels` holds each kingdom's rebels from the latest
+// census.
+int fast_forward_quiet_hours(struct Kingdom kingdoms[], const int rebels[NUM_KINGDOMS], struct HumanPopulation *world_stat,
+                             struct Human_Data *data, int day, int hour);
+
+#endif // FAST_FORWARD_H
@@ -16,4 +16,8 @@
 void apply_story_effects(int chapter_index, int paragraph_index, struct Kingdom kingdoms[], struct Human_Data *data);
 void force_skirmish(int imperial_combatants, int rebel_combatants, struct Kingdom kingdoms[], struct Human_Data *data);
 
+#define STORY_EFFECT_COUNT 6 // One-shot story effects; which have fired is part of a replay keyframe
+void get_story_effects_fired(int fired[STORY_EFFECT_COUNT]);
+void set_story_effects_fired(const int fired[STORY_EFFECT_COUNT]);
+
 #endif // FORCED_STORY_H
\ No newline at end of file
@@ -19,17 +19,42 @@
 #define SIMULATION_TICK_SECONDS 5       // Time in seconds for each simulated hour.
 #define LOG_CLEAR_FREQUENCY_HOURS 4     // How often to clear old log entries.
 #define FADE_SPEED 0.05f                // Opacity change per frame for story transitions.
+#define UI_IDLE_WAKEUP_SECONDS 1.0      // Longest the idle GUI sleeps without input or a new snapshot.
+#define UI_MEMORY_BYTES (1024 * 1024)   // Fixed block holding Nuklear's windows and draw commands.
+#define UI_REPORT_FRAME_ALLOCATIONS 0   // 1 = report GUI frames that allocate from the heap (debug aid).
+#define HISTORY_HOURLY_SAMPLES 168      // Hours of kingdom history kept one by one (a week).
+#define HISTORY_DAILY_SAMPLES 365       // Days kept before they are merged into months.
+#define HISTORY_MONTHLY_SAMPLES 240     // Months kept; older history is dropped.
+#define HISTORY_MONTH_DAYS 30           // Days merged into one monthly sample.
+#define HISTORY_MAX_POINTS 512          // Most points a history chart asks for.
 
 // --- POPULATION & WORLD ---
 #define INITIAL_POPULATION 13000        // Starting population of the empire.
 #define STARTING_BRONZE 80              // Bronze coins a newborn human starts with.
 #define POPULATION_GROWTH_FLOOR 10000   // Below this population, deaths won't exceed births.
+#define AVERAGE_LIFESPAN_DAYS 1875      // Mean natural lifespan. Matches the old steady death rate.
+#define LIFESPAN_SPREAD_DAYS 625        // Lifespans fall evenly within this many days of the mean.
+#define LIFE_CALENDAR_DAYS 32           // Days of upcoming natural deaths kept in the calendar.
+#define AGE_BAND_DAYS 360               // Width of one band of the age pyramids (a year).
+#define LIFE_AGE_BANDS 6                // Bands in the age pyramids; the last one holds everyone older.
 #define HUMAN_ARRAY_GROWTH_FACTOR 1.5   // How much to grow the human array when it's full.
 #define DAYS_IN_MONTH 30.0              // Used for calculating monthly rates.
 #define ACTIVE_HOURS_PER_DAY 12.0       // Used for distributing daily births/deaths over active hours.
 #define DAILY_NATURAL_DEATH_RATE_PER_1000 0.008 // The base daily death rate.
 #define FOOD_SURPLUS_PER_BIRTH 500.0    // How much surplus food is needed to generate one birth.
 #define NUM_KINGDOMS 8                  // 1 Empire + 7 Successor Kingdoms
+#define SHARD_SLACK_PERCENT 10          // Free room kept at the end of each kingdom's shard, as a % of its size.
+#define SHARD_MIN_SLACK 64              // Minimum free room per kingdom shard.
+
+// --- PERFORMANCE ---
+#define SIMULATION_WORKER_THREADS 0     // Worker threads for parallel simulation stages. 0 = one per CPU core.
+#define WORK_TICK_BUDGET_MS 50          // Time each simulated hour may spend on citizens' work. The day's quota is met even if it does not fit.
+#define SHARD_PARTITION_CHUNK 65536     // Humans per task when the population is regrouped into shards.
+#define SPAWN_CHUNK 65536               // Humans per task when many are created at once.
+#define WORLD_GENERATION_SLICE 1048576  // First citizens created between two progress reports.
+#define FAST_FORWARD_MAX_HOURS 24       // Most quiet hours advanced in a single tick. 0 = simulate every hour.
+#define DEFAULT_WORLD_SEED 1            // Seed of the world unless --seed gives another.
+#define JOURNAL_KEYFRAME_DAYS 10        // Days between full keyframes in a replay journal (--record).
 
 // --- UNREST & REBELLION ---
 #define REBELLION_THRESHOLD 2000         // Unrest level for the Empire to collapse.
@@ -70,7 +95,38 @@
 #define MINER_METAL_PRODUCTION 3        // Metal generated by one miner per day (if they find metal).
 #define MINER_METAL_CHANCE_PERCENT 25   // The chance (out of 100) for a miner to find metal instead of stone.
 #define BLACKSMITH_METAL_NEEDS 3        // The number of metals needed to produce weapons
-#define FAMINE_POPULATION_LOSS_PERCENT 5 // The percentage of the population that dies during a famine event.
+#define FAMINE_POPULATION_LOSS_PERCENT 5 // The percentage of a kingdom's population that dies for each hour of famine.
+#define FAMINE_HOURLY_HUNGER_LOSS 10 // Hunger lost by each citizen per hour while their kingdom is starving.
+// Work shift costs (health / hunger lost by one shift of work)
+#define FARMER_HEALTH_COST 5
+#define FARMER_HUNGER_COST 10
+#define BUTCHER_HEALTH_COST 10
+#define BUTCHER_HUNGER_COST 15
+#define LUMBERJACK_HEALTH_COST 15
+#define LUMBERJACK_HUNGER_COST 20
+#define MINER_HEALTH_COST 30
+#define MINER_HUNGER_COST 35
+#define BLACKSMITH_HEALTH_COST 20
+#define BLACKSMITH_HUNGER_COST 25
+#define BLACKSMITH_IDLE_HUNGER_COST 10  // Hunger lost by a blacksmith who has no metal to work.
+#define SOLDIER_HEALTH_COST 5           // Training.
+#define SOLDIER_HUNGER_COST 10
+#define REST_HEALTH_RECOVERY 20         // Health regained by skipping a shift.
+#define EXHAUSTED_HEALTH_THRESHOLD 10   // At or below this health a person can't work.
+#define EXHAUSTED_HEALTH_RECOVERY 5     // Health regained per shift while exhausted.
+// Wages (bronze paid once per payday: MIN + rand() % RANGE)
+#define FARMER_WAGE_MIN 1
+#define FARMER_WAGE_RANGE 30
+#define BUTCHER_WAGE_MIN 1
+#define BUTCHER_WAGE_RANGE 50
+#define LUMBERJACK_WAGE_MIN 1
+#define LUMBERJACK_WAGE_RANGE 40
+#define MINER_WAGE_MIN 1
+#define MINER_WAGE_RANGE 30
+#define BLACKSMITH_WAGE_MIN 1
+#define BLACKSMITH_WAGE_RANGE 85
+#define SOLDIER_WAGE_MIN 20
+#define SOLDIER_WAGE_RANGE 41
 #define WORK_START_HOUR 4               // Hour of the day when work starts.
 #define WORK_END_HOUR 22                // Hour of the day when work ends.
 #define EAT_HUNGER_THRESHOLD 40         // Hunger level at which a person will eat.
@@ -143,9 +199,31 @@
 #define AI_ARMY_SIZE_GOAL_PERCENT 0.08f // AI will try to maintain an army size of 8% of the population.
 #define AI_FESTIVAL_COST 500            // The treasury cost for the AI to host a festival.
 #define AI_FESTIVAL_UNREST_REDUCTION 45 // The amount of unrest reduced by the AI's festival.
-#define AI_FARMER_CONVERSION_COUNT 50   // Number of workers the AI converts to farmers during a food crisis.
 #define AI_FOOD_DAYS_THRESHOLD 1        // AI will consider food a problem if it has less than this many days of food.
-#define AI_STABILITY_ACTION_THRESHOLD 0.1f // AI will act on unrest if its score is above this.
+#define AI_STABILITY_ACTION_THRESHOLD 0.1f // Above this urgency the planning governor weighs the options.
+
+// --- PLANNING GOVERNOR ---
+#define GOVERNOR_TIME_BUDGET_MS 20      // Planning time per daily council. 0 leaves every decision to the heuristic.
+#define GOVERNOR_HORIZON_DAYS 7         // How far ahead each rollout plays.
+#define GOVERNOR_ROLLOUTS_PER_ROUND 16  // Rollouts per candidate action in one round on the worker pool.
+#define GOVERNOR_MAX_ROUNDS 8           // Rounds per decision when there is time for them.
+
+// --- LABOR MARKET ---
+// Shares of the civilian workforce, in permille. They add up to 1000.
+#define LABOR_SHARE_FARMER 500
+#define LABOR_SHARE_BUTCHER 100
+#define LABOR_SHARE_LUMBERJACK 150
+#define LABOR_SHARE_MINER 150
+#define LABOR_SHARE_BLACKSMITH 100
+#define LABOR_MAX_FARMER_SHARE 850      // Farmer share when the granaries are about to run dry.
+#define LABOR_ARMING_SHIFT 40           // Permille moved from the farms to each of mines and forests while the army is built up.
+#define LABOR_TOLERANCE_PERCENT 2       // A job this close to its target is left alone.
+
+// What the governor asked of the labor market today
+#define LABOR_GOAL_NONE 0
+#define LABOR_GOAL_ARM 1                // Recruiting: more metal and wood.
+#define LABOR_GOAL_FEED 2               // Food is running low.
+#define LABOR_GOAL_FAMINE 3             // All hands to the farms.
 
 // --- DIVINE INTERVENTION (The "Borrow from God" System) ---
 #define AI_DIVINE_INTERVENTION_TREASURY_THRESHOLD 3000 // AI must have at least this much in treasury to even consider an intervention.
@@ -0,0 +1,44 @@
+// file: governor.h
+
+#ifndef GOVERNOR_H
+#define GOVERNOR_H
+
+#include "humans.h"
+
+// --- Planning governor ---
+// When something is brewing in a kingdom, the governor doesn't just answer the most urgent
+// problem of the moment: it plays every action it could take today forward for
+// GOVERNOR_HORIZON_DAYS on copies of the kingdom, many times over on the worker pool, and
+// takes the one with the best average outcome. A copy is the kingdom's own record plus its
+// citizens counted per job, so it costs the same however large the population is. In the
+// copies the urgency heuristic plays the days after today.
+// The heuristic also decides on its own whenever the daily council's planning time
+// (GOVERNOR_TIME_BUDGET_MS, or --plan-budget) has run out. How many rollouts fit in the
+// time follows the machine's speed, so the replay journal records every planned choice.
+// Only the simulation thread calls in.
+
+enum GovernorAction {
+    GOVERNOR_HOLD,      // Nothing today; the treasury is saved
+    GOVERNOR_RECRUIT,   // Raise troops and arm the workforce
+    GOVERNOR_FESTIVAL,  // Spend AI_FESTIVAL_COST to calm the populace
+    GOVERNOR_FEED,      // Send more workers to the farms
+    GOVERNOR_ACTIONS
+};
+
+#define GOVERNOR_USE_HEURISTIC (-1) // The planner had no time; the heuristic decides
+
+// Planning time per daily council in milliseconds. 0 leaves every decision to the heuristic.
+void governor_set_budget(int milliseconds);
+
+// Starts the clock on a daily council's planning time
+void governor_begin_council(void);
+
+// The urgency heuristic's everyday action. `reason`, if not NULL, gets the line it logs.
+int governor_heuristic(const struct Kingdom *kingdom, int soldier_count, int rebel_count, const char **reason);
+
+// The best action found by the rollouts, or GOVERNOR_USE_HEURISTIC
+int governor_plan(const struct Kingdom *kingdom, int soldier_count, int rebel_count);
+
+const char *governor_action_name(int action);
+
+#endif // GOVERNOR_H
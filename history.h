@@ -0,0 +1,38 @@
+// file: history.h
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include "humans.h"
+
+// --- Kingdom history ---
+// Keeps each kingdom's population, unrest, treasury and food over the whole run in a fixed
+// amount of memory. Every hour is kept for the last week, every day for the last year and
+// every month before that, until the oldest months fall off the end. A coarse sample holds
+// the lowest, highest and mean value of the hours it covers, so spikes survive downsampling.
+// The simulation records, the GUI reads; both may call in at any time.
+
+enum HistoryMetric {
+    HISTORY_POPULATION,
+    HISTORY_UNREST,
+    HISTORY_TREASURY,
+    HISTORY_FOOD,
+    HISTORY_METRICS
+};
+
+struct HistorySample {
+    float min;
+    float max;
+    float mean;
+};
+
+// Records the kingdoms' current values for `hours` hours (more than 1 after a fast-forward).
+void history_record(const struct Kingdom kingdoms[], int hours);
+
+// Copies the newest `span_hours` of one kingdom's metric (0 = everything kept) into `out`,
+// oldest first, merged down to at most `max_points` samples. Returns how many were written.
+int history_snapshot(int kingdom, enum HistoryMetric metric, int span_hours, int max_points, struct HistorySample out[]);
+
+const char *history_metric_name(enum HistoryMetric metric);
+
+#endif // HISTORY_H
@@ -6,6 +6,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include "shared_data.h"
+#include "rng.h"
 
 // Represents a single political entity
 struct Kingdom
@@ -21,7 +22,7 @@ struct Kingdom
     int stone;
     int metal;
     int weapons;
-    int treasury; // Stored in bronze coins
+    long long treasury; // Stored in bronze coins. Wide enough for the taxes of a cohort-sized empire.
     
     // --- Military Fields ---
     int army_morale; // 0-100, affects combat effectiveness
@@ -33,6 +34,20 @@ struct Kingdom
     int story_food_daily_cap; // 0=no cap, else max food per day
     float story_consumption_modifier;
 
+    // Famine state
+    int famine_hours; // Consecutive hours with empty granaries (0 = no famine)
+
+    // Demographics: fractions of a birth or death carried over to the next hour
+    float birth_fraction;
+    float death_fraction;
+
+    int pending_divine_recruits; // Divine reinforcements granted today, delivered after the daily council
+
+    // Labor market (index = job, 0 = unemployed)
+    int labor_goal;                          // LABOR_GOAL_* set by the governor
+    int labor_share[JOB_BLACKSMITH + 1];     // Wanted share of the civilian workforce, in permille
+    int labor_force[JOB_BLACKSMITH + 1];     // Civilians per job, from the daily census plus today's hires
+
     float divine_tax_modifier;           // Multiplier for tax collection (e.g., 0.75f)
     float divine_production_modifier;    // Multiplier for resource gathering
     int divine_penalty_timer_days;       // How many days the penalty remains
@@ -48,24 +63,48 @@ struct HumanPopulation
     float human_br;
 };
 
+// The part of a human every daily pass reads: kept small so scans stay in cache.
 struct Human_Stats
 {
-    const char* name;
-
     //stats
-    int smart;
     int damage;
     int health;
-    int speed;
     int defense;
     int hunger;
-    int level;
-    double expirience;
 
     //social
     int job;// (1) Farmer, (2) Butcher, (3) Lumberjack, (4) Miner, (5) Blacksmith, (6) Soldier, (7) Rebel
     int kingdom_id; // Which kingdom this human belongs to. 0 is the Empire.
     int bronze;
+
+    //status
+    int alive; // 0 dead - 1 alive
+    int work_day; // Last simulated day this human worked (0 = never)
+    int birth_day; // Simulated day this human was born (may be before day 1)
+    int death_day; // Simulated day this human dies of old age
+
+    // --- Military Fields ---
+    int is_general; // 0 for no, 1 for yes
+
+    int details; // Handle of this human's entry in the details table (0 = none yet)
+};
+
+// The part of a human nothing reads every day: identity, progression and equipment.
+// Only humans who need one get an entry (see human_details). Entries stay put while
+// their owners move around humans[], so the handle in Human_Stats.details stays valid.
+// The armor slots hold market.h tiers once equipment is used.
+struct Human_Details
+{
+    int owner; // Index of the human in humans[], -1 while the entry is free
+    int next_free;
+
+    const char* name;
+
+    //stats
+    int smart;
+    int speed;
+    int level;
+    double expirience;
     int quirks[3];
 
     //armor
@@ -77,21 +116,83 @@ struct Human_Stats
     //items
     int right;
     int left;
-
-    //status
-    int alive; // 0 dead - 1 alive
-    
-    // --- Military Fields ---
-    int is_general; // 0 for no, 1 for yes
 };
 
 struct Human_Data {
     struct Human_Stats *humans;
     int count;
     int capacity;
+
+    // --- Kingdom shards (after the Empire's collapse) ---
+    // Every kingdom owns one contiguous range of humans[]. The first shard_size slots of a
+    // range are in use, the rest up to shard_capacity is room for newcomers and holds
+    // dead placeholders, so loops over the whole array simply skip it.
+    bool is_sharded;
+    int shard_start[NUM_KINGDOMS];
+    int shard_size[NUM_KINGDOMS];
+    int shard_capacity[NUM_KINGDOMS];
+
+    unsigned layout_generation; // Changes whenever living humans move to other indices
+
+    // --- Details table (cold side of the humans, see Human_Details) ---
+    struct Human_Details *details;   // Entry 0 is never used, so a zero handle means "none"
+    int details_count;
+    int details_capacity;
+    int details_free;                // First free entry, 0 if none
+
+    // --- Scratch: one int per human, for the passes that need a list or a map of indices ---
+    int *scratch;                    // Grows with count and is never shrunk
+    int scratch_capacity;
+};
+
+#define DAILY_RECRUIT_POOL 512      // Recruitment candidates remembered per kingdom per day
+#define LABOR_CANDIDATE_POOL 256    // Civilians remembered per job per kingdom per day, for the labor market
+
+// --- One kingdom's daily council ---
+// The citizens are walked once per day. That pass applies taxes and dissent, takes the
+// census and remembers who could be recruited or could change jobs. The decisions
+// that need the whole picture then work from these lists instead of walking the array again.
+struct KingdomDay {
+    // Set before the pass
+    bool dissent_active;
+    int civilian_rebel_chance;       // Out of REBEL_CHANCE_DIVISOR
+    int soldier_defection_chance;    // Out of REBEL_CHANCE_DIVISOR
+    struct RngStream rng;            // The pass's rolls, seeded on the simulation thread
+
+    // Gathered by the pass
+    int taxes_collected;
+    int population;
+    int soldier_count;
+    int rebel_count;
+    int new_rebels;
+    int new_leaders;                 // Cohort rebels to promote to notable leaders
+    int defections;                  // Soldiers who joined the rebels
+
+    int job_census[JOB_BLACKSMITH + 1];              // Civilians per job (0 = unemployed)
+
+    int recruit_candidates[DAILY_RECRUIT_POOL];      // Civilians who could take up arms
+    int recruit_candidate_count;
+    int next_recruit_candidate;                      // First candidate not looked at yet
+    int labor_candidates[JOB_BLACKSMITH + 1][LABOR_CANDIDATE_POOL]; // Civilians per job who could change jobs
+    int labor_candidate_count[JOB_BLACKSMITH + 1];
 };
 
 
+// --- What every human created by spawn_humans starts with ---
+// damage and defense are drawn from [stat_min, stat_min + stat_range) and everything not
+// listed here starts at zero. Only humans with a name get a details entry straight away.
+struct SpawnTemplate {
+    const char *name;   // NULL for ordinary citizens, who are all called "Adam"
+    int health;
+    int hunger;
+    int stat_min;
+    int stat_range;
+    int job;
+    int is_general;
+    int bronze;
+    bool newborn;   // Newborns start at age 0, everyone else at a random age
+};
+
 // Forward declarations of functions defined in other .c files.
 // This tells the compiler that these functions exist and what they look like.
 // The linker will connect them all together later.
@@ -100,29 +201,45 @@ void* simulation_thread_func(void* arg);
 void update_all_kingdom_details_for_gui(struct Kingdom kingdoms[], struct Human_Data *data, GuiSharedData *target_data);
 void life(struct HumanPopulation*);
 void initialize_world_polities(struct Kingdom*);
-void initialize_population(struct Human_Data*);
+typedef void (*progress_fn)(int done, int total);
+void initialize_population(struct Human_Data *data, progress_fn progress);
 void initial_job_assignment(struct Human_Data*);
-void calculate_stable_population_changes(struct Kingdom*, int, int*, int*);
+void calculate_population_changes(struct Kingdom kingdoms[], int out_births[NUM_KINGDOMS], int out_deaths[NUM_KINGDOMS]);
 void alive_status(int, struct Human_Data*);
-void persona(int, struct HumanPopulation*, struct Human_Data*, int);
+int natural_deaths(struct Human_Data *data, const int steady_deaths[NUM_KINGDOMS], const int births[NUM_KINGDOMS],
+                   int population, int day, int hour, int hours);
+void persona(const int births[NUM_KINGDOMS], struct HumanPopulation *world_stat, struct Human_Data *data);
 void trigger_hourly_skirmish(struct Kingdom*, struct Human_Data*);
-void occupation(struct HumanPopulation*, struct Human_Data*);
-void dailyneed(struct Kingdom *kingdom, struct HumanPopulation *world_stat, struct Human_Data *data);
-void payments(struct HumanPopulation*, struct Human_Data*);
+void dailyneed(struct Kingdom kingdoms[], struct HumanPopulation *world_stat, struct Human_Data *data, int work_day);
 void recalculate_kingdom_populations(struct Kingdom*, struct Human_Data*);
 void manage_empire(struct Kingdom*, struct Human_Data*);
 void manage_kingdom_daily(struct Kingdom*, struct Human_Data*);
 void trigger_random_event(struct Kingdom*, struct Human_Data*);
 void compact_dead_humans(struct Human_Data*);
+void shard_population_by_kingdom(struct Human_Data *data);
+struct RngStream;
+// Called on every living human while the population is repartitioned. May change kingdom_id.
+typedef void (*shard_reassign_fn)(struct Human_Stats *human, struct RngStream *rng, void *context);
+bool repartition_population(struct Human_Data *data, shard_reassign_fn reassign, void *context, int census[NUM_KINGDOMS]);
+int reserve_kingdom_slots(struct Human_Data *data, int kingdom_id, int count);
+int spawn_humans(struct Human_Data *data, const struct SpawnTemplate *template, int kingdom_id, int count);
+struct Human_Details *human_details(struct Human_Data *data, int index);
+int *human_scratch(struct Human_Data *data, int count);
+void kingdom_range(const struct Human_Data *data, int kingdom_id, int *begin, int *end);
+void manage_successor_kingdoms_daily(struct Kingdom kingdoms[], struct Human_Data *data);
 void run_ai_governor_decision(struct Kingdom *kingdom, struct Human_Data *data);
-void recruit_soldiers(struct Kingdom *kingdom, struct Human_Data *data);
 int birth_rate(struct HumanPopulation *world_stat, double percentage);
-void occupation(struct HumanPopulation *world_stat, struct Human_Data *data);
-void payments(struct HumanPopulation *world_stat, struct Human_Data *data);
-void collect_taxes(struct Kingdom *kingdom, struct Human_Data *data);
+void occupation(struct Kingdom kingdoms[], struct Human_Data *data);
+void plan_labor_shares(struct Kingdom *kingdom);
+int choose_job_for_hire(struct Kingdom *kingdom);
+void rebalance_labor(struct Kingdom *kingdom, struct KingdomDay *day, struct Human_Data *data);
+void collect_taxes(struct Kingdom *kingdom, const struct KingdomDay *day);
 void update_kingdom_unrest(struct Kingdom *kingdom, struct Human_Data *data);
-void handle_recruitment_and_dissent(struct Kingdom *kingdom, struct Human_Data *data);
-void recruit_soldiers(struct Kingdom *kingdom, struct Human_Data *data);
-void EmpireAI(struct Kingdom *kingdom, struct Human_Data *data);
+void prepare_dissent(struct Kingdom *kingdom, struct KingdomDay *day);
+int recruit_soldiers(struct Kingdom *kingdom, struct KingdomDay *day, struct Human_Data *data);
+void EmpireAI(struct Kingdom *kingdom, struct KingdomDay *day, struct Human_Data *data);
+void update_kingdom_famine(struct Kingdom *kingdom, struct Human_Data *data);
+int check_civil_war_trigger(struct Human_Data *data);
+int check_for_empire_collapse(struct Kingdom kingdoms[], struct Human_Data *data);
 
 #endif // HUMANS_H
\ No newline at end of file
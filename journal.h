@@ -0,0 +1,68 @@
+// file: journal.h
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "humans.h"
+#include "calculations.h"
+#include "work_schedule.h"
+
+// --- Replay journal ---
+// With --record, the simulation writes down everything a run depends on besides its code:
+// the seed, a hash of the build, each story position it takes, each player order, the
+// size of each work slice and each choice of the planning governor (those follow the
+// machine's speed), and each night hour that waited for the player instead of being
+// fast-forwarded, all stamped with their tick.
+// Every day it adds a checksum of the world and every JOURNAL_KEYFRAME_DAYS days a keyframe,
+// a full copy of the simulation's state. With --replay the same run plays again from the
+// journal, and the checksums show whether it still matches. --seek DAY starts the replay
+// from the last keyframe before DAY and simulates the rest without pausing between hours.
+// Only the simulation thread calls in, apart from journal_close.
+
+#define JOURNAL_MAGIC "VLJRNL1"
+#define JOURNAL_VERSION 1
+
+// A run's hours, counted from day 0
+#define JOURNAL_TICK(day, hour) ((long long)(day) * DAY_IN_HOURS + (hour))
+
+// The simulation thread's own variables, saved in every keyframe beside the world
+struct JournalClock {
+    int day;
+    int hour;
+    int empire_has_fallen;
+    int civil_war_raging;
+    int story_chapter;              // Story position the simulation applies
+    int story_paragraph;
+    int rebels[NUM_KINGDOMS];       // From the last census, for the night's fast-forward
+    struct WorkSchedule work_schedule;
+};
+
+bool journal_record(const char *path, uint64_t seed, bool cohorts);
+bool journal_replay(const char *path, uint64_t *seed, bool *cohorts);
+bool journal_replaying(void);
+void journal_close(void);
+
+// Called once at the start of every simulated hour, before the calls below
+void journal_begin_hour(long long tick);
+void journal_story_position(long long tick, int *chapter, int *paragraph);
+int journal_player_commands(long long tick, int commands[], int count, int max);
+bool journal_work_slice(long long tick, int *slice_size);
+
+// Before a night's fast-forward from `tick`, whether the player's input was waiting
+bool journal_player_waiting(long long tick, bool waiting);
+
+// The planning governor's choices (see governor.h), during the hour's daily council
+bool journal_replayed_plan(int kingdom, int *action);
+void journal_plan(int kingdom, int action);
+
+// Called at midnight, after the day's cleanup
+void journal_end_of_day(const struct JournalClock *clock, const struct Kingdom kingdoms[],
+                        const struct HumanPopulation *world_stat, const struct Human_Data *data);
+
+bool journal_seek(int day, struct JournalClock *clock, struct Kingdom kingdoms[],
+                  struct HumanPopulation *world_stat, struct Human_Data *data);
+bool journal_catching_up(long long tick);
+
+#endif // JOURNAL_H
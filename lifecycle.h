@@ -0,0 +1,52 @@
+// file: lifecycle.h
+
+#ifndef LIFECYCLE_H
+#define LIFECYCLE_H
+
+#include <stdint.h>
+#include "humans.h"
+
+// --- Lifespans and the calendar of natural deaths ---
+// Every citizen is given a lifespan when they appear, and natural death comes on the day
+// it runs out. The calendar keeps the citizens due in the next LIFE_CALENDAR_DAYS days in
+// one bucket per day, so each hour only visits the people who actually die in it.
+// Buckets hold indices into humans[]. When the compaction or a regroup reorders the array
+// it reports where everyone went (lifecycle_moved) and the buckets follow. The calendar is
+// only rebuilt from the whole population when its window runs out, or after a move that
+// wasn't reported.
+// The kingdoms' age pyramids are kept up to date as citizens appear, leave and grow older.
+// The cohort model has no ages; there natural deaths still follow the steady rate.
+
+// Days of birth whose citizens still move up a band of the age pyramid as they grow older
+#define LIFE_PYRAMID_DAYS ((LIFE_AGE_BANDS - 1) * AGE_BAND_DAYS + 1)
+
+struct LifeBucket {
+    int *indices;
+    int count;
+    int capacity;
+};
+
+struct LifeCalendar {
+    int today;                                       // Simulated day the calendar is at
+    int built_until;                                 // Deaths before this day are in the buckets
+    unsigned built_generation;                       // Layout of humans[] the indices refer to
+    bool built;
+    struct LifeBucket buckets[LIFE_CALENDAR_DAYS];   // Indexed by day % LIFE_CALENDAR_DAYS
+    int age_pyramid[NUM_KINGDOMS][LIFE_AGE_BANDS];   // Living citizens per age band
+    int recent_births[NUM_KINGDOMS][LIFE_PYRAMID_DAYS]; // Living citizens by day of birth % LIFE_PYRAMID_DAYS
+};
+
+// Defined in lifecycle.c. Only the simulation thread touches it.
+extern struct LifeCalendar g_life_calendar;
+
+void lifecycle_init(int day);
+void lifecycle_set_lifespan(struct Human_Stats *human, uint32_t lifespan_draw, uint32_t age_draw, bool newborn);
+void lifecycle_schedule(struct Human_Data *data, int start_index, int count);
+void lifecycle_start(struct Human_Data *data, int start_index, int count, bool newborn);
+int lifecycle_natural_deaths(struct Human_Data *data, int day, int hour, int hours, int max_deaths);
+// Call for every citizen who dies or leaves humans[], just before their alive flag is cleared
+void lifecycle_remove(const struct Human_Stats *human);
+// humans[] was reordered: old humans[i] is now at moved_to[i], or gone if it is -1
+void lifecycle_moved(const struct Human_Data *data, unsigned old_generation, const int *moved_to, int old_count);
+
+#endif // LIFECYCLE_H
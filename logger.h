@@ -25,6 +25,10 @@ extern pthread_mutex_t g_event_log_mutex;
 extern int g_log_write_index;
 // Index from where the GUI should start reading messages
 extern int g_log_read_index;
+// Messages written since startup, so a reader can copy only what is new
+extern unsigned long g_log_sequence;
+// Changes whenever old messages are cleared
+extern unsigned int g_log_expiry_generation;
 
 
 // --- FUNCTION PROTOTYPES ---
@@ -13,12 +13,12 @@
 #include <pthread.h>
 #include <errno.h>
 #include <limits.h>
+#include <stdint.h>
 
 // Nuklear Implementation (needs to be defined before including headers)
 #define NK_INCLUDE_FIXED_TYPES
 #define NK_INCLUDE_STANDARD_IO
 #define NK_INCLUDE_STANDARD_VARARGS
-#define NK_INCLUDE_DEFAULT_ALLOCATOR
 #define NK_INCLUDE_VERTEX_BUFFER_OUTPUT
 #define NK_INCLUDE_FONT_BAKING
 #define NK_INCLUDE_DEFAULT_FONT
@@ -34,8 +34,6 @@
 // Project-Specific Headers
 #include "humans.h"
 #include "game_config.h"
-#include "story_data.h"
-#include "characters.h"
 #include "logger.h"
 #include "events.h"
 #include "shared_data.h"
@@ -43,7 +41,21 @@
 #include "app_state.h"
 #include "player.h"
 #include "Player/situation_gui.h"
+#include "Player/log_view.h"
+#include "Player/history_gui.h"
+#include "Player/font_cache.h"
+#include "data_files.h"
+#include "story_pack.h"
 #include "calculations.h"
+#include "rng.h"
+#include "workers.h"
+#include "work_schedule.h"
+#include "cohorts.h"
+#include "fast_forward.h"
+#include "lifecycle.h"
+#include "history.h"
+#include "journal.h"
+#include "governor.h"
 
 #define WINDOW_WIDTH 1400
 #define WINDOW_HEIGHT 700
@@ -59,8 +71,81 @@ struct HumanPopulation world_stat;
 struct Human_Data human_data;
 struct Kingdom kingdoms[NUM_KINGDOMS];
 bool g_story_position_changed = false;
+struct RngStream g_sim_rng;
+
+// The GUI only redraws on input, on a new snapshot or while something animates.
+// Set to false by --continuous-render to draw every frame as before.
+static bool g_render_on_demand = true;
+// True while the GUI loop can be woken; guarded by g_data_mutex.
+static bool g_gui_listening = false;
+// Set by GLFW when the window's contents were lost and must be drawn again.
+static bool g_window_damaged = false;
+// Nuklear runs from this block instead of the heap; see UI_REPORT_FRAME_ALLOCATIONS.
+static unsigned char g_ui_memory[UI_MEMORY_BYTES];
+// The baked story fonts when they came from the cache; the fonts point into it.
+static struct FontCache g_font_cache;
+// The world's seed (--seed, or the one in a replayed journal) and the day --seek asks for.
+static uint64_t g_world_seed = DEFAULT_WORLD_SEED;
+static int g_seek_day = STARTING_ZERO;
 
 // --- Helper Functions ---
+
+/**
+ * @brief Marks g_shared_data as changed and wakes the GUI to show it.
+ * Call with g_data_mutex held.
+ */
+static void publish_snapshot_locked(void) {
+    g_shared_data.version++;
+    if (g_gui_listening) glfwPostEmptyEvent();
+}
+
+static void window_refresh_callback(GLFWwindow *window) {
+    (void)window;
+    g_window_damaged = true;
+}
+
+/**
+ * @brief Hashes this frame's Nuklear draw commands (FNV-1a) together with the window size.
+ * Two frames with the same hash would put the same pixels on screen.
+ */
+static uint64_t hash_draw_commands(const struct nk_context *ctx, int width, int height) {
+    const unsigned char *bytes = nk_buffer_memory_const(&ctx->memory);
+    uint64_t hash = 14695981039346656037ULL;
+    for (nk_size i = STARTING_ZERO; i < ctx->memory.allocated; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    hash = (hash ^ (uint64_t)width) * 1099511628211ULL;
+    hash = (hash ^ (uint64_t)height) * 1099511628211ULL;
+    return hash;
+}
+
+// The kingdom panel's text, formatted once per snapshot instead of once per frame
+struct KingdomLabels {
+    char population[64];
+    char resources[128];
+    char unrest[64];
+    char troops[64];
+    char ages[256];
+    bool has_ages;
+};
+
+static void format_kingdom_labels(const GuiKingdomData *kingdom, struct KingdomLabels *labels) {
+    snprintf(labels->population, sizeof(labels->population), "Population: %d", kingdom->population);
+    snprintf(labels->resources, sizeof(labels->resources), "F: %d|W: %d|S: %d|M: %d|T: %lld",
+        kingdom->food, kingdom->wood, kingdom->stone, kingdom->metal, kingdom->treasury);
+    snprintf(labels->unrest, sizeof(labels->unrest), "Unrest: %d | Morale: %d", kingdom->unrest_level, kingdom->army_morale);
+    int total_troops = kingdom->job_counts[JOB_SWORDSMAN] + kingdom->job_counts[JOB_ARCHER] + kingdom->job_counts[JOB_CAVALRY];
+    snprintf(labels->troops, sizeof(labels->troops), "Troops: %d | Rebels: %d", total_troops, kingdom->job_counts[JOB_REBEL]);
+    // Age pyramid, one entry per year; the last band holds everyone older
+    int written = snprintf(labels->ages, sizeof(labels->ages), "Ages:");
+    int aged = STARTING_ZERO;
+    for (int b = STARTING_ZERO; b < LIFE_AGE_BANDS; b++) {
+        aged += kingdom->age_bands[b];
+        written += snprintf(labels->ages + written, sizeof(labels->ages) - written, " %d%s",
+            kingdom->age_bands[b], (b == LIFE_AGE_BANDS - STARTING_ONE) ? "+" : " |");
+    }
+    labels->has_ages = aged > STARTING_ZERO;
+}
 static void update_story_and_fade(AppState *state) {
     pthread_mutex_lock(&g_data_mutex);
     g_shared_data.current_story_chapter = state->current_chapter_index;
@@ -135,30 +220,52 @@ static void set_dark_theme(struct nk_context *ctx) {
     ctx->style.window.rounding = rounding;
 }
 
-/**
- * @brief Draws log entries from the global circular buffer one by one.
- * This ensures the parent nk_group can correctly calculate its content height.
- */
-static void draw_log_from_circular_buffer(struct nk_context *ctx) {
-    // Set a dynamic row layout so each label can determine its own height.
-    nk_layout_row_dynamic(ctx, STARTING_ZERO, STARTING_ONE);
+// --- The Main Application ---
+int main(int argc, char **argv) {
+    player_setup(&theplayer); // initalize player stats
 
-    // Safely read from the circular buffer
-    pthread_mutex_lock(&g_event_log_mutex);
-    int read_idx = g_log_read_index;
-    while (read_idx != g_log_write_index) {
-        if (g_log_entries[read_idx].timestamp > STARTING_ZERO) {
-            // Using nk_label_wrap is safer for potentially long lines.
-            nk_label_wrap(ctx, g_log_entries[read_idx].message);
+    // --cohorts: simulate the population as cohorts instead of one record per citizen
+    // --numa: pin the simulation workers and keep their data on their own NUMA node
+    // --continuous-render: redraw the GUI every frame even when nothing changes
+    // --seed N: generate the world from seed N
+    // --record FILE: write a replay journal of the run (see journal.h)
+    // --replay FILE: play a recorded run again; --seek DAY: skip ahead to DAY
+    // --plan-budget MS: the planning governor's time per daily council (0 = heuristic only)
+    const char *record_path = NULL, *replay_path = NULL;
+    for (int i = STARTING_ONE; i < argc; i++) {
+        if (strcmp(argv[i], "--cohorts") == POSITION_ZERO) g_cohorts.enabled = true;
+        if (strcmp(argv[i], "--numa") == POSITION_ZERO) workers_set_numa(true);
+        if (strcmp(argv[i], "--continuous-render") == POSITION_ZERO) g_render_on_demand = false;
+        if (i + STARTING_ONE < argc) {
+            if (strcmp(argv[i], "--seed") == POSITION_ZERO) g_world_seed = strtoull(argv[++i], NULL, 10);
+            else if (strcmp(argv[i], "--record") == POSITION_ZERO) record_path = argv[++i];
+            else if (strcmp(argv[i], "--replay") == POSITION_ZERO) replay_path = argv[++i];
+            else if (strcmp(argv[i], "--seek") == POSITION_ZERO) g_seek_day = atoi(argv[++i]);
+            else if (strcmp(argv[i], "--plan-budget") == POSITION_ZERO) governor_set_budget(atoi(argv[++i]));
         }
-        read_idx = (read_idx + STARTING_ONE) % MAX_LOG_ENTRIES;
     }
-    pthread_mutex_unlock(&g_event_log_mutex);
-}
+    if (record_path != NULL && replay_path != NULL) {
+        fprintf(stderr, "Fatal: --record and --replay can't be used together.\n");
+        return 1;
+    }
+    if (replay_path != NULL) {
+        bool recorded_with_cohorts = false;
+        if (!journal_replay(replay_path, &g_world_seed, &recorded_with_cohorts)) return 1;
+        g_cohorts.enabled = recorded_with_cohorts;
+    } else if (record_path != NULL && !journal_record(record_path, g_world_seed, g_cohorts.enabled)) {
+        return 1;
+    }
 
-// --- The Main Application ---
-int main(int argc, char **argv) {
-    player_setup(&theplayer); // initalize player stats
+    // The story is read from the story pack, next to the executable or in the working directory
+    char story_path[4096];
+    if (!find_data_file(argv[POSITION_ZERO], STORY_PACK_FILE, story_path, sizeof(story_path)) &&
+        !find_data_file(argv[POSITION_ZERO], "civilization/" STORY_PACK_FILE, story_path, sizeof(story_path))) {
+        snprintf(story_path, sizeof(story_path), "%s", STORY_PACK_FILE);
+    }
+    if (!story_pack_open(story_path)) {
+        fprintf(stderr, "Fatal: No story to tell. Build the story pack with Tools/pack_story.c.\n");
+        return 1;
+    }
     
     // --- All initialization code remains the same ---
     pthread_mutex_init(&g_data_mutex, NULL);
@@ -194,20 +301,46 @@ int main(int argc, char **argv) {
     glfwInit();
     window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Chronicles of Veloria", NULL, NULL);
     glfwMakeContextCurrent(window);
-    ctx = nk_glfw3_init(window, NK_GLFW3_INSTALL_CALLBACKS);
+    ctx = nk_glfw3_init_fixed(window, NK_GLFW3_INSTALL_CALLBACKS, g_ui_memory, sizeof(g_ui_memory));
+    glfwSetWindowRefreshCallback(window, window_refresh_callback);
     
+    // The fonts are looked up next to the executable first, then from the working directory.
+    // A baked atlas from an earlier start is used if it matches; otherwise the fonts are baked and saved.
     struct nk_font_atlas *atlas;
-    nk_glfw3_font_stash_begin(&atlas);
-    struct nk_font_config config = nk_font_config(STARTING_ZERO);
-    config.range = extended_glyph_ranges;
-    const char *font_path = "civilization/Fonts/Cinzel-Bold.ttf";
-    font_default = nk_font_atlas_add_from_file(atlas, font_path, 16.0f, &config);
-    font_large = nk_font_atlas_add_from_file(atlas, font_path, 28.0f, &config);
-    font_title = nk_font_atlas_add_from_file(atlas, font_path, 38.0f, &config);
-    nk_glfw3_font_stash_end();
+    const float font_sizes[] = {16.0f, 28.0f, 38.0f};
+    char font_path[4096], cache_path[4096];
+    bool found_font = find_data_file(argv[POSITION_ZERO], "Fonts/Cinzel-Bold.ttf", font_path, sizeof(font_path)) ||
+                      find_data_file(argv[POSITION_ZERO], "civilization/Fonts/Cinzel-Bold.ttf", font_path, sizeof(font_path));
+    uint64_t font_key = found_font ? font_cache_key(font_path, font_sizes, STARTING_THREE, extended_glyph_ranges) : STARTING_ZERO;
+    // A font path too long for the cache's name only means the fonts are baked at every start
+    bool use_cache = true;
+    if (snprintf(cache_path, sizeof(cache_path), "%s.atlas", font_path) >= (int)sizeof(cache_path)) use_cache = false;
+
+    if (font_key != STARTING_ZERO && use_cache && font_cache_load(cache_path, font_key, extended_glyph_ranges, &g_font_cache) &&
+        g_font_cache.font_count == STARTING_THREE) {
+        nk_glfw3_font_stash_load(g_font_cache.image, g_font_cache.width, g_font_cache.height, g_font_cache.null_uv,
+                                 g_font_cache.glyphs, g_font_cache.fonts, g_font_cache.pixel_heights, g_font_cache.font_count);
+        font_default = &g_font_cache.fonts[POSITION_ZERO];
+        font_large = &g_font_cache.fonts[STARTING_ONE];
+        font_title = &g_font_cache.fonts[POSITION_TWO];
+    } else if (font_key != STARTING_ZERO) {
+        font_cache_close(&g_font_cache);
+        nk_glfw3_font_stash_begin(&atlas);
+        struct nk_font_config config = nk_font_config(STARTING_ZERO);
+        config.range = extended_glyph_ranges;
+        font_default = nk_font_atlas_add_from_file(atlas, font_path, font_sizes[POSITION_ZERO], &config);
+        font_large = nk_font_atlas_add_from_file(atlas, font_path, font_sizes[STARTING_ONE], &config);
+        font_title = nk_font_atlas_add_from_file(atlas, font_path, font_sizes[POSITION_TWO], &config);
+        int atlas_width, atlas_height;
+        const void *atlas_image = nk_font_atlas_bake(atlas, &atlas_width, &atlas_height, NK_FONT_ATLAS_RGBA32);
+        if (use_cache && font_default && font_large && font_title) {
+            font_cache_save(cache_path, font_key, atlas, atlas_image, atlas_width, atlas_height);
+        }
+        nk_glfw3_font_stash_upload(atlas_image, atlas_width, atlas_height);
+    }
 
     if (!font_default || !font_large || !font_title) {
-        fprintf(stderr, "Warning: Failed to load custom font '%s'. Falling back to default font.\n", font_path);
+        fprintf(stderr, "Warning: Failed to load custom font '%s'. Falling back to default font.\n", found_font ? font_path : "Fonts/Cinzel-Bold.ttf");
         nk_glfw3_font_stash_begin(&atlas);
         font_default = nk_font_atlas_add_default(atlas, 14.0f, STARTING_ZERO);
         font_large = nk_font_atlas_add_default(atlas, 24.0f, STARTING_ZERO);
@@ -220,9 +353,9 @@ int main(int argc, char **argv) {
 
     AppState state = {STARTING_ZERO};
     state.story_opacity = 1.0f;
-    state.character_window_open = calloc(TOTAL_CHARACTERS, sizeof(bool));
-    state.has_reached_end_of_chapter = calloc(TOTAL_CHAPTERS, sizeof(bool));
-    if (story[POSITION_ZERO].paragraph_count == STARTING_ONE) { state.has_reached_end_of_chapter[POSITION_ZERO] = true; }
+    state.character_window_open = calloc(story_character_count() + STARTING_ONE, sizeof(bool)); // Never 0 bytes, even without characters
+    state.has_reached_end_of_chapter = calloc(story_chapter_count(), sizeof(bool));
+    if (story_paragraph_count(POSITION_ZERO) == STARTING_ONE) { state.has_reached_end_of_chapter[POSITION_ZERO] = true; }
     if (state.character_window_open == NULL || state.has_reached_end_of_chapter == NULL) {
         fprintf(stderr, "Fatal: Could not allocate memory for UI state.\\n");
         return 1;
@@ -232,15 +365,42 @@ int main(int argc, char **argv) {
     pthread_mutex_lock(&g_event_log_mutex);
     state.last_log_write_index = g_log_write_index;
     pthread_mutex_unlock(&g_event_log_mutex);
+
+    struct KingdomLabels kingdom_labels[NUM_KINGDOMS];
+    unsigned long labels_version = STARTING_ZERO;
+    bool have_labels = false;
+    uint64_t last_frame_hash = STARTING_ZERO;
+    bool ui_settled = false; // The last frame looked exactly like the one before it
+    unsigned long frame_number = STARTING_ZERO;
+    bool reported_ui_memory_full = false;
+
+    pthread_mutex_lock(&g_data_mutex);
+    g_gui_listening = true;
+    pthread_mutex_unlock(&g_data_mutex);
     
     // --- 4. The Main Loop ---
     while(!glfwWindowShouldClose(window)) {
-        glfwPollEvents();
+        // Sleep until input or a new snapshot arrives, unless something is still moving
+        bool animating = state.fade_state != STARTING_ZERO || state.log_autoscroll_state != STARTING_ZERO;
+        if (g_render_on_demand && ui_settled && !animating) {
+            glfwWaitEventsTimeout(UI_IDLE_WAKEUP_SECONDS);
+        } else {
+            glfwPollEvents();
+        }
         nk_glfw3_new_frame();
+        nk_size heap_allocations_before = nk_glfw3_heap_allocations();
 
         pthread_mutex_lock(&g_data_mutex);
         state.sim_data = g_shared_data;
         pthread_mutex_unlock(&g_data_mutex);
+
+        if (!have_labels || labels_version != state.sim_data.version) {
+            for (int i = STARTING_ZERO; i < NUM_KINGDOMS; i++) {
+                format_kingdom_labels(&state.sim_data.kingdoms[i], &kingdom_labels[i]);
+            }
+            labels_version = state.sim_data.version;
+            have_labels = true;
+        }
         
         if (state.fade_state == -STARTING_ONE) {
             state.story_opacity -= FADE_SPEED;
@@ -251,9 +411,9 @@ int main(int argc, char **argv) {
         }
 
         // --- Step 1: Determine if ANY popup window is currently active ---
-        bool is_any_popup_active = state.show_policies_window;
+        bool is_any_popup_active = state.show_policies_window || state.show_history_window;
         if (!is_any_popup_active) {
-            for (int i = STARTING_ZERO; i < TOTAL_CHARACTERS; i++) {
+            for (int i = STARTING_ZERO; i < story_character_count(); i++) {
                 if (state.character_window_open[i]) {
                     is_any_popup_active = true;
                     break;
@@ -288,26 +448,16 @@ int main(int argc, char **argv) {
                         if (state.sim_data.kingdoms[i].is_active) {
                             const char *title = (i==POSITION_ZERO) ? "The Great Empire" : "Successor Kingdom";
                             if (nk_tree_push_id(ctx, NK_TREE_TAB, title, (i==POSITION_ZERO ? NK_MAXIMIZED : NK_MINIMIZED), i)) {
-                                char buffer[256];
+                                const struct KingdomLabels *labels = &kingdom_labels[i];
                                 nk_layout_row_dynamic(ctx, 15, STARTING_ONE);
-                                snprintf(buffer, sizeof(buffer), "Population: %d", state.sim_data.kingdoms[i].population);
-                                nk_label(ctx, buffer, NK_TEXT_LEFT);
-                                snprintf(buffer, sizeof(buffer), "F: %d|W: %d|S: %d|M: %d|T: %d",
-                                    state.sim_data.kingdoms[i].food,
-                                    state.sim_data.kingdoms[i].wood, 
-                                    state.sim_data.kingdoms[i].stone,
-                                    state.sim_data.kingdoms[i].metal, 
-                                    state.sim_data.kingdoms[i].treasury);
-                                nk_label(ctx, buffer, NK_TEXT_LEFT);
+                                nk_label(ctx, labels->population, NK_TEXT_LEFT);
+                                nk_label(ctx, labels->resources, NK_TEXT_LEFT);
                                 int unrest = state.sim_data.kingdoms[i].unrest_level;
                                 struct nk_color color = (unrest > REBELLION_THRESHOLD) ? nk_rgb(RGB_UNREST_RED) :
                                                         (unrest > DISSENT_THRESHOLD) ? nk_rgb(RGB_UNREST_YELLOW_LIGHT) : nk_rgb(RGB_UNREST_GRAY_LIGHT);
-                                snprintf(buffer, sizeof(buffer), "Unrest: %d | Morale: %d", unrest, state.sim_data.kingdoms[i].army_morale);
-                                nk_label_colored(ctx, buffer, NK_TEXT_LEFT, color);
-                                int total_troops = state.sim_data.kingdoms[i].job_counts[JOB_SWORDSMAN] + state.sim_data.kingdoms[i].job_counts[JOB_ARCHER] + state.sim_data.kingdoms[i].job_counts[JOB_CAVALRY];
-                                nk_labelf(ctx, NK_TEXT_LEFT, "Troops: %d | Rebels: %d", 
-                                    total_troops, 
-                                    state.sim_data.kingdoms[i].job_counts[JOB_REBEL]);
+                                nk_label_colored(ctx, labels->unrest, NK_TEXT_LEFT, color);
+                                nk_label(ctx, labels->troops, NK_TEXT_LEFT);
+                                if (labels->has_ages) nk_label(ctx, labels->ages, NK_TEXT_LEFT);
                                 nk_tree_pop(ctx);
                             }
                         }
@@ -319,7 +469,7 @@ int main(int argc, char **argv) {
                 nk_layout_row_dynamic(ctx, 250, STARTING_ONE);
                 if (nk_group_begin(ctx, "LogGroup", NK_WINDOW_BORDER)) {
                     if (state.log_autoscroll_state == POSITION_TWO) { nk_group_set_scroll(ctx, "LogGroup", STARTING_ZERO, UINT_MAX); state.log_autoscroll_state = STARTING_ZERO; }
-                    draw_log_from_circular_buffer(ctx);
+                    draw_log_view(ctx, "LogGroup");
                     pthread_mutex_lock(&g_event_log_mutex);
                     if (state.last_log_write_index != g_log_write_index) { state.log_autoscroll_state = STARTING_ONE; state.last_log_write_index = g_log_write_index; }
                     pthread_mutex_unlock(&g_event_log_mutex);
@@ -329,14 +479,13 @@ int main(int argc, char **argv) {
                 nk_group_end(ctx);
             }
             if (nk_group_begin(ctx, "CenterPanel", NK_WINDOW_NO_SCROLLBAR)) {
-                const Chapter *current_chapter = &story[state.current_chapter_index];
                 struct nk_color text_color = nk_rgba(220, 220, 220, 255 * state.story_opacity);
                 nk_style_push_font(ctx, &font_title->handle);
-                nk_layout_row_dynamic(ctx, 45, STARTING_ONE); nk_label_colored(ctx, current_chapter->title, NK_TEXT_CENTERED, text_color);
+                nk_layout_row_dynamic(ctx, 45, STARTING_ONE); nk_label_colored(ctx, story_chapter_title(state.current_chapter_index), NK_TEXT_CENTERED, text_color);
                 nk_style_pop_font(ctx);
-                if (current_chapter->perspectives) {
-                    const char* perspective = current_chapter->perspectives[state.current_paragraph_index];
-                    if (perspective && strcmp(perspective, "Narrator") != 0) {
+                {
+                    const char* perspective = story_perspective(state.current_chapter_index, state.current_paragraph_index);
+                    if (strcmp(perspective, "Narrator") != 0) {
                         nk_layout_row_dynamic(ctx, 40, STARTING_ONE); nk_spacer(ctx);
                         nk_style_push_font(ctx, &font_large->handle);
                         nk_layout_row_dynamic(ctx, 30, STARTING_ONE); nk_label_colored(ctx, perspective, NK_TEXT_CENTERED, text_color);
@@ -348,7 +497,7 @@ int main(int argc, char **argv) {
                 float ratios[] = {0.15f, 0.70f, 0.15f};
                 nk_layout_row(ctx, NK_DYNAMIC, 350, 3, ratios);
                 nk_spacer(ctx);
-                nk_label_colored_wrap(ctx, current_chapter->paragraphs[state.current_paragraph_index], text_color);
+                nk_label_colored_wrap(ctx, story_paragraph(state.current_chapter_index, state.current_paragraph_index), text_color);
                 nk_spacer(ctx);
                 nk_style_pop_font(ctx);
                 nk_group_end(ctx);
@@ -365,9 +514,9 @@ int main(int argc, char **argv) {
                 bool is_unlocked = state.has_reached_end_of_chapter[state.current_chapter_index];
                 if (is_unlocked) {
                     if (nk_button_label(ctx, "Next Chapter")) {
-                        if (state.current_chapter_index < TOTAL_CHAPTERS - STARTING_ONE) {
+                        if (state.current_chapter_index < story_chapter_count() - STARTING_ONE) {
                             state.current_chapter_index++; state.current_paragraph_index = STARTING_ZERO;
-                            if (story[state.current_chapter_index].paragraph_count == STARTING_ONE) { state.has_reached_end_of_chapter[state.current_chapter_index] = true; }
+                            if (story_paragraph_count(state.current_chapter_index) == STARTING_ONE) { state.has_reached_end_of_chapter[state.current_chapter_index] = true; }
                             update_story_and_fade(&state);
                         }
                     }
@@ -382,15 +531,15 @@ int main(int argc, char **argv) {
                 nk_layout_row_dynamic(ctx, 40, STARTING_ONE);
                 if (nk_combo_begin_label(ctx, "Characters", nk_vec2(nk_widget_width(ctx), 200))) {
                     nk_layout_row_dynamic(ctx, 25, STARTING_ONE);
-                    for (int i=0; i < TOTAL_CHARACTERS; i++) {
-                        if (nk_combo_item_label(ctx, characters[i].name, NK_TEXT_LEFT)) {
+                    for (int i=0; i < story_character_count(); i++) {
+                        if (nk_combo_item_label(ctx, story_character_name(i), NK_TEXT_LEFT)) {
                             state.character_window_open[i] = true;
                         }
                     }
                     nk_combo_end(ctx);
                 }
                 float remaining_space = nk_window_get_content_region(ctx).h;
-                nk_layout_row_dynamic(ctx, remaining_space - 280, STARTING_ONE); nk_spacer(ctx);
+                nk_layout_row_dynamic(ctx, remaining_space - 324, STARTING_ONE); nk_spacer(ctx);
                 nk_layout_row_dynamic(ctx, 40, STARTING_ONE);
                 nk_style_push_color(ctx, &ctx->style.button.normal.data.color, nk_rgb(170, 40, 40)); nk_style_push_color(ctx, &ctx->style.button.hover.data.color, nk_rgb(180, 50, 50)); nk_style_push_color(ctx, &ctx->style.button.active.data.color, nk_rgb(190, 60, 60));
                 nk_style_push_color(ctx, &ctx->style.button.text_normal, nk_rgb(255, 255, 255)); nk_style_push_color(ctx, &ctx->style.button.text_hover, nk_rgb(255, 255, 255)); nk_style_push_color(ctx, &ctx->style.button.text_active, nk_rgb(255, 255, 255));
@@ -406,10 +555,11 @@ int main(int argc, char **argv) {
             if (state.fade_state == 0) {
                 struct nk_rect center_panel_bounds = nk_rect(350.0f, 0.0f, WINDOW_WIDTH - 350.0f - 250.0f, WINDOW_HEIGHT);
                 if (nk_input_is_mouse_click_in_rect(&ctx->input, NK_BUTTON_LEFT, center_panel_bounds)) {
-                    if (state.current_paragraph_index < story[state.current_chapter_index].paragraph_count - STARTING_ONE) {
+                    if (state.current_paragraph_index < story_paragraph_count(state.current_chapter_index) - STARTING_ONE) {
                         state.current_paragraph_index++;
-                        if (state.current_paragraph_index == story[state.current_chapter_index].paragraph_count - STARTING_ONE) {
+                        if (state.current_paragraph_index == story_paragraph_count(state.current_chapter_index) - STARTING_ONE) {
                             state.has_reached_end_of_chapter[state.current_chapter_index] = true;
+                            story_prefetch_chapter(state.current_chapter_index + STARTING_ONE); // The reader may go on
                         }
                         update_story_and_fade(&state);
                     }
@@ -420,8 +570,7 @@ int main(int argc, char **argv) {
                     }
                 }
             }
-            // For immidiate story effects.
-            apply_story_effects(state.current_chapter_index, state.current_paragraph_index, kingdoms, &human_data);
+            // The story's effects are applied by the simulation at the start of its next hour
         }
 
         if (state.show_policies_window) {
@@ -468,14 +617,8 @@ int main(int argc, char **argv) {
 
                     if (can_afford_festival) {
                         if (nk_button_label(ctx, "Host Festival (-50 Unrest)")) {
-                            pthread_mutex_lock(&g_data_mutex);
-                            if (g_shared_data.kingdoms[POSITION_ZERO].treasury >= PLAYER_FESTIVAL_COST) {
-                                g_shared_data.kingdoms[POSITION_ZERO].treasury -= PLAYER_FESTIVAL_COST;
-                                g_shared_data.kingdoms[POSITION_ZERO].unrest_level -= PLAYER_FESTIVAL_UNREST_REDUCTION;
-                                if (g_shared_data.kingdoms[POSITION_ZERO].unrest_level < STARTING_ZERO) { g_shared_data.kingdoms[POSITION_ZERO].unrest_level = STARTING_ZERO; }
-                                log_event("A grand festival is held! The people rejoice and unrest falls.");
-                            }
-                            pthread_mutex_unlock(&g_data_mutex);
+                            // The simulation holds it at the start of its next hour
+                            if (!player_queue_command(PLAYER_COMMAND_FESTIVAL)) log_event("The heralds are still busy with your last orders.");
                         }
                     } else {
                         nk_button_label(ctx, "Host Festival (150k)");
@@ -525,20 +668,53 @@ int main(int argc, char **argv) {
             nk_end(ctx);
         }
 
+        if (state.show_history_window) {
+            draw_history_window(ctx, &state, WINDOW_WIDTH, WINDOW_HEIGHT);
+        }
+
+        if (ctx->memory.needed > ctx->memory.memory.size && !reported_ui_memory_full) {
+            fprintf(stderr, "Warning: The GUI needs %lu bytes but UI_MEMORY_BYTES is %d. Some widgets were not drawn.\n",
+                    (unsigned long)ctx->memory.needed, UI_MEMORY_BYTES);
+            reported_ui_memory_full = true;
+        }
+
         // --- Final Rendering ---
+        // A frame that looks exactly like the one on screen is dropped instead of drawn.
         int width, height;
         glfwGetWindowSize(window, &width, &height);
-        glViewport(0, 0, width, height);
-        glClear(GL_COLOR_BUFFER_BIT);
-        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-        nk_glfw3_render(NK_ANTI_ALIASING_ON);
-        glfwSwapBuffers(window);
+        uint64_t frame_hash = hash_draw_commands(ctx, width, height);
+        ui_settled = (frame_hash == last_frame_hash);
+        last_frame_hash = frame_hash;
+        if (!g_render_on_demand || !ui_settled || g_window_damaged) {
+            g_window_damaged = false;
+            glViewport(0, 0, width, height);
+            glClear(GL_COLOR_BUFFER_BIT);
+            glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+            nk_glfw3_render(NK_ANTI_ALIASING_ON);
+            glfwSwapBuffers(window);
+        } else {
+            nk_clear(ctx);
+        }
+
+        // After the first frame the draw buffers only grow when a frame is bigger than any before it
+        nk_size frame_allocations = nk_glfw3_heap_allocations() - heap_allocations_before;
+        if (UI_REPORT_FRAME_ALLOCATIONS && frame_number > STARTING_ZERO && frame_allocations > STARTING_ZERO) {
+            fprintf(stderr, "Debug: GUI frame %lu made %lu heap allocation(s).\n", frame_number, (unsigned long)frame_allocations);
+        }
+        frame_number++;
     }
 
+    pthread_mutex_lock(&g_data_mutex);
+    g_gui_listening = false;
+    pthread_mutex_unlock(&g_data_mutex);
+
     // --- 5. Cleanup ---
     free(state.character_window_open);
     free(state.has_reached_end_of_chapter);
     nk_glfw3_shutdown();
+    font_cache_close(&g_font_cache);
+    story_pack_close();
+    journal_close(); // Anything the simulation writes from here on is dropped
     glfwDestroyWindow(window);
     glfwTerminate();
     pthread_mutex_destroy(&g_data_mutex);
@@ -565,6 +741,11 @@ void update_all_kingdom_details_for_gui(struct Kingdom kingdoms[], struct Human_
             }
         }
     }
+    for (int k = STARTING_ZERO; g_cohorts.enabled && k < NUM_KINGDOMS; k++) {
+        for (int j = STARTING_ZERO; j <= JOB_REBEL; j++) {
+            temp_job_counts[k][j] += cohort_job_count(k, j);
+        }
+    }
 
     // --- 2. Now, copy all raw data directly, kingdom by kingdom ---
     for (int k = STARTING_ZERO; k < NUM_KINGDOMS; k++) {
@@ -583,6 +764,9 @@ void update_all_kingdom_details_for_gui(struct Kingdom kingdoms[], struct Human_
         for (int j = STARTING_ZERO; j < 10; j++) {
             target_data->kingdoms[k].job_counts[j] = temp_job_counts[k][j];
         }
+        for (int b = STARTING_ZERO; b < LIFE_AGE_BANDS; b++) {
+            target_data->kingdoms[k].age_bands[b] = g_cohorts.enabled ? STARTING_ZERO : g_life_calendar.age_pyramid[k][b];
+        }
     }
 }
 
@@ -590,33 +774,123 @@ void update_all_kingdom_details_for_gui(struct Kingdom kingdoms[], struct Human_
 // === SIMULATION THREAD (Runs in the background) ===
 // =============================================================================
 
+/**
+ * @brief Shows how far world generation has come while the first citizens are created.
+ */
+static void report_world_generation(int done, int total) {
+    pthread_mutex_lock(&g_data_mutex);
+    snprintf(g_shared_data.civil_war_status, MAX_NUM_CHAR, "Status: Creating the world (%d%%)",
+             total > STARTING_ZERO ? (int)((long long)done * 100 / total) : 100);
+    publish_snapshot_locked();
+    pthread_mutex_unlock(&g_data_mutex);
+}
+
+/**
+ * @brief Every citizen in humans[start_index, end_index) who hasn't worked today works, is paid and eats.
+ */
+static void work_humans(int start_index, int end_index, int sim_day) {
+    // We create a temporary struct to pass the subset of the population
+    struct HumanPopulation world_stat_subset = world_stat;
+    struct Human_Data human_data_subset = {0};
+    human_data_subset.humans = &human_data.humans[start_index];
+    human_data_subset.count = end_index - start_index;
+    // The slice borrows the population's scratch buffer, grown here so the slice never grows its own
+    if (human_scratch(&human_data, human_data_subset.count) == NULL) return;
+    human_data_subset.scratch = human_data.scratch;
+    human_data_subset.scratch_capacity = human_data.scratch_capacity;
+
+    occupation(kingdoms, &human_data_subset);
+    dailyneed(kingdoms, &world_stat_subset, &human_data_subset, sim_day);
+}
+
+/**
+ * @brief Advances the quiet night hours from `sim_hour` and returns how many passed.
+ */
+static int advance_quiet_hours(const int rebels[NUM_KINGDOMS], int sim_day, int sim_hour) {
+    int quiet_hours = fast_forward_quiet_hours(kingdoms, rebels, &world_stat, &human_data, sim_day, sim_hour);
+    if (quiet_hours > STARTING_ZERO) history_record(kingdoms, quiet_hours);
+    return quiet_hours;
+}
+
 void* simulation_thread_func(void* arg) {
     int empire_has_fallen = STARTING_ZERO;
+    int civil_war_raging = STARTING_ZERO;
 
+    srand((unsigned)g_world_seed);
+    rng_seed(&g_sim_rng, g_world_seed);
+    workers_start(SIMULATION_WORKER_THREADS);
     life(&world_stat);
     initialize_world_polities(kingdoms);
 
-    human_data.humans = malloc(world_stat.human_population * sizeof(struct Human_Stats));
+    // In cohort mode nobody is simulated one by one; the array starts out empty
+    int individual_population = g_cohorts.enabled ? STARTING_ZERO : world_stat.human_population;
+    human_data.humans = malloc((individual_population > STARTING_ZERO ? individual_population : STARTING_ONE) * sizeof(struct Human_Stats));
     if (human_data.humans == NULL) {
         fprintf(stderr, "Memory allocation failed!\n");
         pthread_exit(NULL);
     }
-    human_data.count = world_stat.human_population;
-
-    initialize_population(&human_data);
-    initial_job_assignment(&human_data);
+    human_data.count = individual_population;
 
     int sim_hour = STARTING_THREE;
     int sim_day = STARTING_ONE;
+    lifecycle_init(sim_day);
+
+    initialize_population(&human_data, report_world_generation);
+    // Cohorts get their jobs and generals from cohorts_init; the individual array is still empty
+    if (g_cohorts.enabled) {
+        cohorts_init(world_stat.human_population, &human_data);
+    } else {
+        initial_job_assignment(&human_data);
+    }
+    recalculate_kingdom_populations(kingdoms, &human_data);
+
+    struct WorkSchedule work_schedule;
+    work_schedule_init(&work_schedule);
+    int rebels[NUM_KINGDOMS] = {STARTING_ZERO};
+    int seek_reported_day = STARTING_ZERO;
+
+    // A seek starts from the replay's last keyframe before the day asked for, at the midnight it was taken
+    struct JournalClock clock;
+    if (g_seek_day > STARTING_ZERO && journal_seek(g_seek_day, &clock, kingdoms, &world_stat, &human_data)) {
+        sim_day = clock.day;
+        sim_hour = clock.hour;
+        empire_has_fallen = clock.empire_has_fallen;
+        civil_war_raging = clock.civil_war_raging;
+        work_schedule = clock.work_schedule;
+        memcpy(rebels, clock.rebels, sizeof(rebels));
+        sim_hour += advance_quiet_hours(rebels, sim_day, sim_hour);
+    }
 
     // --- Main Simulation Loop ---
     while (STARTING_ONE) {
+        long long tick = JOURNAL_TICK(sim_day, sim_hour);
+        journal_begin_hour(tick);
+        // rand() restarts from the main stream every hour, so saving the stream in a keyframe saves both
+        srand(rng_next(&g_sim_rng));
+
+        // The story position is taken now; a change after this waits for the next hour
+        pthread_mutex_lock(&g_story_mutex);
+        g_story_position_changed = false;
+        pthread_mutex_unlock(&g_story_mutex);
 
         int story_ch, story_p;
         pthread_mutex_lock(&g_data_mutex);
         story_ch = g_shared_data.current_story_chapter;
         story_p = g_shared_data.current_story_paragraph;
         pthread_mutex_unlock(&g_data_mutex);
+        journal_story_position(tick, &story_ch, &story_p);
+
+        // The player's orders are carried out at the start of the hour; a replay uses the recorded ones
+        int commands[PLAYER_COMMAND_QUEUE];
+        int command_count = player_take_commands(commands, PLAYER_COMMAND_QUEUE);
+        if (command_count > STARTING_ZERO && journal_replaying()) {
+            log_event("A recorded run is replaying; your orders are not carried out.");
+            command_count = STARTING_ZERO;
+        }
+        command_count = journal_player_commands(tick, commands, command_count, PLAYER_COMMAND_QUEUE);
+        for (int i = STARTING_ZERO; i < command_count; i++) {
+            player_carry_out_command(commands[i], kingdoms);
+        }
         
         int population_at_hour_start = STARTING_ZERO;
         for(int i = STARTING_ZERO; i < NUM_KINGDOMS; i++) {
@@ -624,47 +898,55 @@ void* simulation_thread_func(void* arg) {
         }
         if (population_at_hour_start == POSITION_ZERO) population_at_hour_start = world_stat.human_population;
 
-        int new_births = STARTING_ZERO, new_deaths = STARTING_ZERO;
-        calculate_stable_population_changes(&kingdoms[POSITION_ZERO], population_at_hour_start, &new_births, &new_deaths);
+        int new_births[NUM_KINGDOMS], new_deaths[NUM_KINGDOMS];
+        calculate_population_changes(kingdoms, new_births, new_deaths);
 
         apply_story_effects(story_ch, story_p, kingdoms, &human_data);
 
-        alive_status(new_deaths, &human_data);
-        persona(new_births, &world_stat, &human_data, empire_has_fallen);
+        natural_deaths(&human_data, new_deaths, new_births, population_at_hour_start, sim_day, sim_hour, STARTING_ONE);
+        if (g_cohorts.enabled) {
+            cohort_births(kingdoms, new_births);
+        } else {
+            persona(new_births, &world_stat, &human_data);
+        }
 
         if (!empire_has_fallen) {
             trigger_hourly_skirmish(&kingdoms[POSITION_ZERO], &human_data);
         }
 
-        // Determine which third of the population
-        int hours_per_batch = DAY_IN_HOURS / BATCHES_PER_DAY; // 3 batches per day
-        int current_batch = sim_hour / hours_per_batch;
-        int population_third = human_data.count / BATCHES_PER_DAY;
-        int start_index = current_batch * population_third;
-        int end_index = (current_batch == STARTING_TWO) ? human_data.count : (current_batch + STARTING_ONE) * population_third;
-
-
+        // Hand out this hour's share of the day's work
+        int start_index, end_index;
+        work_schedule_next_slice(&work_schedule, &human_data, sim_day, sim_hour, &start_index, &end_index);
         if (sim_hour >= WORK_START_HOUR && sim_hour < WORK_END_HOUR) {
-             // We create a temporary struct to pass the subset of the population
-            struct HumanPopulation world_stat_subset = world_stat;
-            struct Human_Data human_data_subset;
-            human_data_subset.humans = &human_data.humans[start_index];
-            human_data_subset.count = end_index - start_index;
-
-            // Run hourly tasks only for the current batch
-            occupation(&world_stat_subset, &human_data_subset);
-            dailyneed(&kingdoms[STARTING_ZERO], &world_stat_subset, &human_data_subset);
-
-            // Distribute payments across the day for each batch
-            if (current_batch == STARTING_ZERO && sim_hour == STARTING_SIX) { // First batch gets paid at hour 6
-                payments(&world_stat_subset, &human_data_subset);
-            } else if (current_batch == STARTING_ONE && sim_hour == STARTING_FOURTHEEN) { // Second batch at hour 14
-                payments(&world_stat_subset, &human_data_subset);
-            } else if (current_batch == STARTING_TWO && sim_hour == STARTING_TWENTY_TWO) { // Third batch at hour 22
-                payments(&world_stat_subset, &human_data_subset);
+            // The slices follow the machine's speed, so a replay takes them from the journal
+            int slice_size = end_index - start_index;
+            if (journal_work_slice(tick, &slice_size)) {
+                work_schedule_resize_slice(&work_schedule, &human_data, slice_size, start_index, &end_index);
             }
         }
+
+        if (end_index > start_index) {
+            work_humans(start_index, end_index, sim_day);
+            work_schedule_finish_slice(&work_schedule, end_index - start_index);
+        }
+
+        // Newborns placed behind the cursor work too
+        int catch_up_begin[NUM_KINGDOMS], catch_up_end[NUM_KINGDOMS];
+        int catch_up_ranges = work_schedule_catch_up(&work_schedule, &human_data, sim_hour, catch_up_begin, catch_up_end);
+        for (int r = STARTING_ZERO; r < catch_up_ranges; r++) {
+            work_humans(catch_up_begin[r], catch_up_end[r], sim_day);
+        }
+
+        // The cohorts work their whole day in one step at the start of the shift
+        if (g_cohorts.enabled && sim_hour == WORK_START_HOUR) {
+            cohort_work_day(kingdoms);
+        }
         
+        // Famine is a kingdom-wide state, resolved once per hour instead of once per citizen
+        for (int i = STARTING_ZERO; i < NUM_KINGDOMS; i++) {
+            update_kingdom_famine(&kingdoms[i], &human_data);
+        }
+
         // Recalculate totals based on the entire population to ensure accuracy for GUI and daily events
         recalculate_kingdom_populations(kingdoms, &human_data);
         int true_total_population = STARTING_ZERO;
@@ -678,10 +960,25 @@ void* simulation_thread_func(void* arg) {
             if (!empire_has_fallen) {
                 manage_empire(&kingdoms[POSITION_ZERO], &human_data);
                 trigger_random_event(&kingdoms[POSITION_ZERO], &human_data);
+
+                // Once the day is settled, see whether the rebels can challenge the army...
+                int war_now = check_civil_war_trigger(&human_data);
+                if (war_now && !civil_war_raging) {
+                    log_event("CIVIL WAR! The rebels are strong enough to challenge the Imperial army!");
+                } else if (!war_now && civil_war_raging) {
+                    log_event("The rebellion loses its momentum. The civil war is over.");
+                }
+                civil_war_raging = war_now;
+
+                // ...and whether the Empire survives the night.
+                if (check_for_empire_collapse(kingdoms, &human_data)) {
+                    empire_has_fallen = STARTING_ONE;
+                    civil_war_raging = STARTING_ZERO;
+                }
             } else {
+                manage_successor_kingdoms_daily(kingdoms, &human_data);
                 for (int i = STARTING_ONE; i < NUM_KINGDOMS; i++) {
                     if (kingdoms[i].is_active) {
-                        manage_kingdom_daily(&kingdoms[i], &human_data);
                         trigger_random_event(&kingdoms[i], &human_data);
                     }
                 }
@@ -691,25 +988,43 @@ void* simulation_thread_func(void* arg) {
         // =========================================================================
         // === GATHER AND UPDATE GUI DATA (CRITICAL SECTION) =======================
         // =========================================================================
+        history_record(kingdoms, STARTING_ONE);
+
+        bool catching_up = journal_catching_up(tick);
         pthread_mutex_lock(&g_data_mutex);
         update_all_kingdom_details_for_gui(kingdoms, &human_data, &g_shared_data);
+        for (int k = STARTING_ZERO; k < NUM_KINGDOMS; k++) {
+            rebels[k] = g_shared_data.kingdoms[k].job_counts[JOB_REBEL];
+        }
         snprintf(g_shared_data.world_population, MAX_NUM_CHAR, "World Pop: %d", world_stat.human_population);
         snprintf(g_shared_data.current_hour, MAX_NUM_CHAR, "Day %d, %02d:00", sim_day, sim_hour);
-        if (!empire_has_fallen) { 
+        if (!empire_has_fallen && civil_war_raging) {
+            snprintf(g_shared_data.civil_war_status, MAX_NUM_CHAR, "Status: Civil War!");
+        } else if (!empire_has_fallen) { 
             snprintf(g_shared_data.civil_war_status, MAX_NUM_CHAR, "Status: The Empire Reigns"); 
         } else { 
             snprintf(g_shared_data.civil_war_status, MAX_NUM_CHAR, "Status: Age of Kingdoms"); 
         }
+        if (!catching_up) {
+            publish_snapshot_locked();
+        } else if (sim_day != seek_reported_day) {
+            snprintf(g_shared_data.civil_war_status, MAX_NUM_CHAR, "Status: Seeking day %d...", g_seek_day);
+            publish_snapshot_locked(); // Once a day is enough to show the seek's progress
+            seek_reported_day = sim_day;
+        }
         pthread_mutex_unlock(&g_data_mutex);
         
         if (sim_hour % LOG_CLEAR_FREQUENCY_HOURS == POSITION_ZERO) { 
             clear_old_log_entries();
         }
 
-        struct timespec sleep_time;
-        sleep_time.tv_sec = SIMULATION_TICK_SECONDS;
-        sleep_time.tv_nsec = STARTING_ZERO;
-        nanosleep(&sleep_time, NULL);
+        // A seek runs at full speed until it reaches its day
+        if (!catching_up) {
+            struct timespec sleep_time;
+            sleep_time.tv_sec = SIMULATION_TICK_SECONDS;
+            sleep_time.tv_nsec = STARTING_ZERO;
+            nanosleep(&sleep_time, NULL);
+        }
 
         sim_hour++;
         if (sim_hour >= DAY_IN_HOURS) {
@@ -719,11 +1034,24 @@ void* simulation_thread_func(void* arg) {
 
         // Daily cleanup still happens once per day for the entire population
         if (sim_hour == POSITION_ZERO) {
+            if (g_cohorts.enabled) cohort_demote_ordinary(&human_data);
             compact_dead_humans(&human_data);
+
+            clock = (struct JournalClock){.day = sim_day, .hour = sim_hour, .empire_has_fallen = empire_has_fallen,
+                                          .civil_war_raging = civil_war_raging, .story_chapter = story_ch,
+                                          .story_paragraph = story_p};
+            memcpy(clock.rebels, rebels, sizeof(rebels));
+            clock.work_schedule = work_schedule;
+            journal_end_of_day(&clock, kingdoms, &world_stat, &human_data);
         }
+
+        // Quiet night hours pass in one step; the hour after them is simulated normally
+        sim_hour += advance_quiet_hours(rebels, sim_day, sim_hour);
     }
     
+    workers_stop();
     free(human_data.humans);
+    free(human_data.scratch);
     return NULL;
 }
 
@@ -31,4 +31,21 @@ struct PlayerStat
 
 void player_setup(struct PlayerStat *theplayer);
 
+// --- Player commands ---
+// The GUI queues the player's orders and the simulation carries them out at the start of its
+// next hour, so every order lands on a known tick and a replay can repeat it.
+
+struct Kingdom;
+
+#define PLAYER_COMMAND_QUEUE 16 // Orders waiting for the next hour; more are refused
+
+enum PlayerCommand {
+    PLAYER_COMMAND_FESTIVAL = 1
+};
+
+int player_queue_command(int command);
+int player_take_commands(int commands[], int max);
+int player_commands_waiting(void);
+void player_carry_out_command(int command, struct Kingdom *kingdoms);
+
 #endif // PLAYER_H
\ No newline at end of file
@@ -0,0 +1,25 @@
+// file: rng.h
+
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+#define RNG_LANES 8 // Independent xorshift32 generators interleaved in one stream
+
+// A fast random stream for the hot simulation loops.
+// The lanes are stepped together, so a block of numbers can be produced with SSE2/AVX2.
+// Every build (SSE2, AVX2 or plain C) produces exactly the same sequence for the same seed.
+struct RngStream {
+    uint32_t lanes[RNG_LANES];
+    int next_lane; // Lane used by the next single draw
+};
+
+// The simulation's main stream. Defined in main.c.
+extern struct RngStream g_sim_rng;
+
+void rng_seed(struct RngStream *rng, uint64_t seed);
+uint32_t rng_next(struct RngStream *rng);
+void rng_fill(struct RngStream *rng, uint32_t *out, int count);
+
+#endif // RNG_H
@@ -13,7 +13,7 @@ typedef struct {
     int population;
     int unrest_level;
     int army_morale;
-    int treasury;
+    long long treasury;
 
     // Raw resource counts
     int food;
@@ -23,6 +23,7 @@ typedef struct {
     
     // Detailed job counts
     int job_counts[10]; // Index corresponds to JOB_* defines
+    int age_bands[LIFE_AGE_BANDS]; // Age pyramid, from the calendar of deaths
 
 } GuiKingdomData;
 
@@ -42,6 +43,8 @@ typedef struct {
     int current_story_chapter;
     int current_story_paragraph;
 
+    unsigned long version; // Bumped whenever the simulation publishes new data
+
 } GuiSharedData;
 // The 'extern' keyword is a promise to the compiler:
 // "These variables exist and are defined in ONE .c file somewhere else.
@@ -0,0 +1,80 @@
+// file: story_pack.h
+
+#ifndef STORY_PACK_H
+#define STORY_PACK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// --- The story pack ---
+// The chapters, their perspectives and the character bios live in one file that is mapped
+// at startup, so the text is read from disk only when a paragraph is shown and writers can
+// change the story without rebuilding the game. Tools/pack_story.c writes it from
+// story_data.h and characters.h.
+//
+// Layout: a header, then the chapter, paragraph, perspective and character tables, then
+// every string NUL-terminated in one UTF-8 blob. Table fields holding text are offsets into
+// the blob. Each chapter's title and paragraphs are stored next to each other in the blob,
+// and the perspective names and bios follow the last chapter.
+// FNV-1a checksums guard the pack. The one of the tables is checked at open; each chapter's,
+// and the one of the text after the chapters, the first time that text is read. Damaged
+// text is replaced with a note to pack the story again.
+
+#define STORY_PACK_FILE "story.pack"
+#define STORY_PACK_MAGIC "VLSTORY"
+#define STORY_PACK_VERSION 3
+#define STORY_PACK_NARRATOR 0 // Perspective 0 is always the narrator
+
+struct StoryPackHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t chapter_count;
+    uint32_t paragraph_count;    // Over all chapters
+    uint32_t perspective_count;
+    uint32_t character_count;
+    uint32_t chapters_at;        // File offsets of the tables and the text
+    uint32_t paragraphs_at;
+    uint32_t perspectives_at;
+    uint32_t characters_at;
+    uint32_t text_at;
+    uint32_t text_size;
+    uint32_t unused;
+    uint64_t tables_checksum;    // FNV-1a of the tables, in file order
+    uint64_t extras_checksum;    // FNV-1a of the text after the last chapter
+};
+
+struct StoryPackChapter {
+    uint32_t title;
+    uint32_t first_paragraph;    // Index into the paragraph table
+    uint32_t paragraph_count;
+    uint32_t text_end;           // End of the chapter's text in the blob
+    uint64_t checksum;           // FNV-1a of the chapter's text, title to text_end
+};
+
+struct StoryPackParagraph {
+    uint32_t text;
+    uint32_t perspective;        // Index into the perspective table
+};
+
+struct StoryPackCharacter {
+    uint32_t name;
+    uint32_t title;
+    uint32_t description;
+};
+
+bool story_pack_open(const char *path);
+void story_pack_close(void);
+void story_prefetch_chapter(int chapter);
+
+int story_chapter_count(void);
+const char *story_chapter_title(int chapter);
+int story_paragraph_count(int chapter);
+const char *story_paragraph(int chapter, int paragraph);
+const char *story_perspective(int chapter, int paragraph);
+
+int story_character_count(void);
+const char *story_character_name(int character);
+const char *story_character_title(int character);
+const char *story_character_description(int character);
+
+#endif // STORY_PACK_H
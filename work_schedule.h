@@ -0,0 +1,41 @@
+// file: work_schedule.h
+
+#ifndef WORK_SCHEDULE_H
+#define WORK_SCHEDULE_H
+
+#include <time.h>
+#include "humans.h"
+
+// Decides which part of humans[] works in each hour of the working day.
+// A cursor walks the array once per day. Each hour takes as many humans as fit the tick's
+// time budget (WORK_TICK_BUDGET_MS), sized from the throughput measured so far, but never
+// fewer than needed to finish the day on time. Citizens carry the day they last worked in
+// work_day, so nobody works twice.
+// Once the world is sharded, newborns fill the free room of their kingdom's shard, which may
+// lie behind the cursor. Each hour catches up just those slots, born since the hour before.
+// Only when the array was regrouped, which moves everyone, is all of it behind the cursor
+// swept again.
+struct WorkSchedule {
+    int day;                 // Simulated day the cursor belongs to
+    int cursor;              // Next index of humans[] to hand out
+    double ns_per_human;     // Smoothed cost of one human, 0 until first measured
+    struct timespec slice_started;
+    unsigned layout_generation;     // Human_Data's layout when last caught up
+    int shard_end[NUM_KINGDOMS];    // End of each kingdom's shard when last caught up
+};
+
+void work_schedule_init(struct WorkSchedule *schedule);
+// Returns the range of humans[] to work this hour. Empty outside working hours.
+void work_schedule_next_slice(struct WorkSchedule *schedule, const struct Human_Data *data,
+                              int day, int hour, int *begin, int *end);
+// Replaces the slice just handed out with one of `slice_size` humans, as recorded in a replay journal.
+void work_schedule_resize_slice(struct WorkSchedule *schedule, const struct Human_Data *data,
+                                int slice_size, int begin, int *end);
+// Records how long the slice handed out last took, to size the next one.
+void work_schedule_finish_slice(struct WorkSchedule *schedule, int slice_size);
+// Fills the ranges behind the cursor that still have to work today and returns how many
+// (at most NUM_KINGDOMS). They follow from the cursor and the layout, so a replay needs no journal.
+int work_schedule_catch_up(struct WorkSchedule *schedule, const struct Human_Data *data, int hour,
+                           int begin[NUM_KINGDOMS], int end[NUM_KINGDOMS]);
+
+#endif // WORK_SCHEDULE_H
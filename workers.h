@@ -0,0 +1,30 @@
+// file: workers.h
+
+#ifndef WORKERS_H
+#define WORKERS_H
+
+#include <stdbool.h>
+
+#define MAX_WORKER_THREADS 64
+
+// A small pool of simulation worker threads.
+// Task i of a run always goes to worker (i % worker count), so the same worker
+// keeps handling the same slice of data from one run to the next.
+
+// Starts the pool. worker_count <= 0 means one worker per online CPU core.
+void workers_start(int worker_count);
+
+// NUMA mode (Linux): set before workers_start. Every worker is pinned to one core, filling
+// one node before the next. Memory is placed on the node of the thread that first touches
+// it, so data handled by the same task index every run stays next to its worker.
+void workers_set_numa(bool enabled);
+bool workers_numa(void);
+void workers_stop(void);
+int workers_count(void);
+
+// Runs task(0..task_count-1, context) on the pool and waits for all of them.
+// Without a pool (or with a single worker) the tasks run on the calling thread.
+// Only the simulation thread may call this; runs can't be nested.
+void workers_run(int task_count, void (*task)(int task_index, void *context), void *context);
+
+#endif // WORKERS_H